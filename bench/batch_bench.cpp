@@ -0,0 +1,127 @@
+// ParseBatch timings on a WorkStealingThreadPool against a serial ParseStruct loop,
+// for several batch sizes and thread counts. Messages are mostly small with a few large ones.
+
+#include <ProtobufLight/ProtobufLightParallel.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct BenchRow
+{
+    int64_t id{};
+    std::string name{};
+    std::vector<int32_t> values{};
+};
+
+struct BenchBatchMessage
+{
+    int64_t id{};
+    std::string tag{};
+    std::vector<BenchRow> rows{};
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<BenchRow>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.id, FieldMeta<1>{"id"});
+        cb(obj.name, FieldMeta<2>{"name"});
+        cb(obj.values, FieldMeta<3>{"values"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<BenchBatchMessage>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.id, FieldMeta<1>{"id"});
+        cb(obj.tag, FieldMeta<2>{"tag"});
+        cb(obj.rows, FieldMeta<3>{"rows"});
+    }
+};
+
+static constexpr int kRounds = 5;
+
+template<typename Fn>
+static double BestMillis(Fn&& fn)
+{
+    double best = 1e30;
+    for (int round = 0; round < kRounds; ++round)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static std::vector<std::string> MakeBatch(size_t count)
+{
+    std::vector<std::string> inputs;
+    inputs.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        BenchBatchMessage message;
+        message.id = static_cast<int64_t>(i);
+        message.tag = "tag-" + std::to_string(i % 100);
+
+        // One message in 500 is a thousand times bigger than the others
+        const size_t rows = i % 500 == 0 ? 4000 : 4;
+        for (size_t r = 0; r < rows; ++r)
+        {
+            auto& row = message.rows.emplace_back();
+            row.id = static_cast<int64_t>(r);
+            row.name = "row-" + std::to_string(r);
+            row.values = { 1, 2, 3, static_cast<int32_t>(r) };
+        }
+
+        inputs.emplace_back();
+        ProtobufLight::Reflection::SerializeStruct(message, inputs.back());
+    }
+    return inputs;
+}
+
+int main(int argc, char** argv)
+{
+    // Thread counts go up to the hardware concurrency, or to the first argument
+    const size_t maxThreads = argc > 1 ? std::max<size_t>(1, std::stoul(argv[1])) : std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2)
+        threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    std::printf("ParseBatch, best of %d, speedup against a serial ParseStruct loop\n", kRounds);
+    for (size_t count : { size_t(1000), size_t(10000), size_t(100000) })
+    {
+        const std::vector<std::string> inputs = MakeBatch(count);
+        size_t bytes = 0;
+        for (const auto& input : inputs)
+            bytes += input.size();
+
+        std::vector<BenchBatchMessage> outputs(count);
+        const double serialMs = BestMillis([&]
+        {
+            for (size_t i = 0; i < count; ++i)
+                ProtobufLight::Reflection::ParseStruct(outputs[i], reinterpret_cast<const uint8_t*>(inputs[i].data()), inputs[i].size());
+        });
+        std::printf("%7zu messages, %9zu bytes   serial %9.2f ms\n", count, bytes, serialMs);
+
+        for (size_t threads : threadCounts)
+        {
+            ProtobufLight::WorkStealingThreadPool pool(threads);
+            size_t failures = 0;
+            const double batchMs = BestMillis([&]
+            {
+                failures += ProtobufLight::Reflection::ParseBatch(inputs, outputs, pool).failures;
+            });
+            std::printf("    %3zu threads   batch %9.2f ms   speedup %5.2fx   (failures %zu)\n",
+                threads, batchMs, serialMs / batchMs, failures);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+// Parse and lookup timings for map<string, Msg> with 100k entries
+// in the ordered, flat and hash map representations.
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+struct BenchVal
+{
+    int32_t a{};
+    std::string b{};
+};
+
+template<typename Map>
+struct BenchMaps
+{
+    Map entries{};
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<BenchVal>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.a, FieldMeta<1>{"a"});
+        cb(obj.b, FieldMeta<2>{"b"});
+    }
+};
+
+template<typename Map>
+struct ProtobufLight::Reflection::ProtobufTrait<BenchMaps<Map>>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.entries, FieldMeta<1>{"entries"});
+    }
+};
+
+using OrderedMaps = BenchMaps<std::map<std::string, BenchVal>>;
+using FlatMaps = BenchMaps<ProtobufLight::FlatMap<std::string, BenchVal>>;
+using HashMaps = BenchMaps<std::unordered_map<std::string, BenchVal>>;
+
+static constexpr size_t kEntries = 100000;
+static constexpr int kRounds = 5;
+
+static std::string MakeKey(size_t i)
+{
+    // Scatter the keys so the wire order is not already sorted
+    return "key-" + std::to_string((i * 2654435761u) % 1000003u);
+}
+
+template<typename Fn>
+static double BestMillis(Fn&& fn)
+{
+    double best = 1e30;
+    for (int round = 0; round < kRounds; ++round)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+template<typename T>
+static void Run(const char* name, const std::string& wire, const std::vector<std::string>& keys)
+{
+    T parsed;
+    const double parseMs = BestMillis([&]
+    {
+        parsed = T{};
+        ProtobufLight::Reflection::ParseStruct(parsed, reinterpret_cast<const uint8_t*>(wire.data()), wire.size());
+    });
+
+    int64_t sum = 0;
+    const double lookupMs = BestMillis([&]
+    {
+        for (const auto& key : keys)
+            sum += parsed.entries.find(key)->second.a;
+    });
+
+    std::printf("%-10s parse %8.2f ms   lookup %8.2f ms   (entries %zu, checksum %lld)\n",
+        name, parseMs, lookupMs, parsed.entries.size(), static_cast<long long>(sum));
+}
+
+int main()
+{
+    OrderedMaps source;
+    std::vector<std::string> keys;
+    keys.reserve(kEntries);
+    for (size_t i = 0; i < kEntries; ++i)
+    {
+        keys.push_back(MakeKey(i));
+        source.entries[keys.back()] = BenchVal{ static_cast<int32_t>(i), "value" };
+    }
+
+    // std::map serializes in key order; rebuild the wire bytes in insertion order
+    std::string wire;
+    for (const auto& key : keys)
+    {
+        OrderedMaps single;
+        single.entries.emplace(key, source.entries.at(key));
+        ProtobufLight::Reflection::SerializeStruct(single, wire);
+    }
+
+    std::printf("map<string, Msg>, %zu entries, %zu wire bytes, best of %d\n", source.entries.size(), wire.size(), kRounds);
+    Run<OrderedMaps>("std::map", wire, keys);
+    Run<FlatMaps>("FlatMap", wire, keys);
+    Run<HashMaps>("unordered", wire, keys);
+    return 0;
+}
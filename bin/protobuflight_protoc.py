@@ -1,6 +1,8 @@
 #!/usr/bin/env python3
 import re
 import sys
+import argparse
+import copy
 from pathlib import Path
 from collections import OrderedDict
 
@@ -29,6 +31,76 @@ SCALAR_PROTOS = {
     "bool"
 }
 
+# ---- Generator options -----------------------------------------------------
+class GeneratorOptions:
+    def __init__(self):
+        # Emit allocator-aware structs using std::pmr containers
+        self.pmr = False
+        # How optional fields track presence: "optional" (std::optional) or "hasbits" (packed bitmask)
+        self.presence = "optional"
+        # Member order: "declaration" (.proto order) or "packed" (by decreasing alignment, less padding)
+        self.layout = "declaration"
+        # "Message.field" paths read from --cold-fields, moved to the lazily allocated cold struct
+        self.cold_fields = set()
+        # Store enums in the smallest integer type holding all their values, unless marked open
+        self.narrow_enums = False
+        # Store singular bools as bits of a packed word, repeated bools as ProtobufLight::BoolVector
+        self.pack_bools = False
+        # Oneof alternatives estimated larger than this many bytes are stored in a ProtobufLight::Box, 0 disables boxing
+        self.box_threshold = 0
+        # Map representation: "ordered" (std::map), "flat" (ProtobufLight::FlatMap) or "hash" (std::unordered_map)
+        self.map = "ordered"
+        # Store bytes fields as ProtobufLight::SharedBytes, slices of a shared input buffer instead of copies
+        self.shared_bytes = False
+        # Store repeated string and bytes fields as ProtobufLight::StringList, one blob plus end offsets
+        self.compact_strings = False
+        # Top-level messages that also get a struct-of-arrays <Message>Columns companion
+        self.columns = []
+        # Store every string field as ProtobufLight::InternedString, not only those marked [(protobuflight.intern) = true]
+        self.intern_strings = False
+        # Inline capacity of repeated scalar, enum and string fields stored as ProtobufLight::SmallVector, 0 keeps std::vector
+        self.small_vector = 0
+
+OPTIONS = GeneratorOptions()
+# Every message name of the file being generated, nested ones included
+MESSAGE_NAMES = set()
+MESSAGES_BY_NAME = {}
+# Messages referenced through a NodePtr, declared before the structs
+RECURSIVE_TARGETS = set()
+ENUMS_BY_NAME = {}
+
+def cpp_base_type(proto_type, intern=False):
+    if proto_type == "string" and (intern or OPTIONS.intern_strings):
+        return "ProtobufLight::InternedString"
+    if OPTIONS.shared_bytes and proto_type == "bytes":
+        return "ProtobufLight::SharedBytes"
+    if OPTIONS.pmr and proto_type in ("string", "bytes"):
+        return "std::pmr::string"
+    return PROTO_TO_CPP.get(proto_type, proto_type)
+
+def cpp_vector_type(item, inline_capacity=0):
+    if OPTIONS.pack_bools and item == "bool":
+        return "ProtobufLight::BasicBoolVector<std::pmr::polymorphic_allocator<uint64_t>>" if OPTIONS.pmr else "ProtobufLight::BoolVector"
+    if inline_capacity > 0:
+        if OPTIONS.pmr:
+            return f"ProtobufLight::SmallVector<{item}, {inline_capacity}, std::pmr::polymorphic_allocator<{item}>>"
+        return f"ProtobufLight::SmallVector<{item}, {inline_capacity}>"
+    return f"std::pmr::vector<{item}>" if OPTIONS.pmr else f"std::vector<{item}>"
+
+def cpp_node_type(message):
+    if OPTIONS.pmr:
+        return f"ProtobufLight::NodePtr<{message}, std::pmr::polymorphic_allocator<{message}>>"
+    return f"ProtobufLight::NodePtr<{message}>"
+
+def cpp_map_type(key, value):
+    if OPTIONS.map == "flat":
+        if OPTIONS.pmr:
+            return f"ProtobufLight::FlatMap<{key}, {value}, std::less<{key}>, std::pmr::polymorphic_allocator<std::pair<{key}, {value}>>>"
+        return f"ProtobufLight::FlatMap<{key}, {value}>"
+    if OPTIONS.map == "hash":
+        return f"std::pmr::unordered_map<{key}, {value}>" if OPTIONS.pmr else f"std::unordered_map<{key}, {value}>"
+    return f"std::pmr::map<{key}, {value}>" if OPTIONS.pmr else f"std::map<{key}, {value}>"
+
 # ---- regex patterns --------------------------------------------------------
 COMMENT_RE = re.compile(r'//.*?$|/\*.*?\*/', re.DOTALL | re.MULTILINE)
 IMPORT_RE = re.compile(r'import\s+"([^"]+)";')
@@ -43,8 +115,10 @@ FIELD_RE = re.compile(r'''
         (?P<type>\w+)
     )\s+
     (?P<name>\w+)\s*=\s*(?P<number>\d+)
+    (?:\s*\[(?P<options>[^\]]*)\])?
 ''', re.VERBOSE)
-ENUM_FIELD_RE = re.compile(r'(?P<name>\w+)\s*=\s*(?P<num>\d+)\s*;?')
+ENUM_FIELD_RE = re.compile(r'(?P<name>\w+)\s*=\s*(?P<num>-?\d+)\s*;?')
+ENUM_OPTION_RE = re.compile(r'\boption\s+(?P<name>[\w\.\(\)]+)\s*=\s*(?P<value>\w+)\s*;')
 
 # ---- AST classes -----------------------------------------------------------
 class Field:
@@ -55,19 +129,78 @@ class Field:
         self.label = label
         self.map_key = map_key
         self.map_value = map_value
+        self.options = {}
+        # Stored in the message's ColdData side struct instead of inline
+        self.cold = False
+        # Member of a ColdData struct, the parent message already handles its storage
+        self.in_cold_struct = False
+        # Message typed field closing a cycle of the schema, stored behind a ProtobufLight::NodePtr
+        self.recursive = False
 
     def cpp_type(self):
         if self.map_key and self.map_value:
-            key = PROTO_TO_CPP.get(self.map_key, self.map_key)
-            val = PROTO_TO_CPP.get(self.map_value, self.map_value)
-            return f"std::map<{key}, {val}>"
-        base = PROTO_TO_CPP.get(self.proto_type, self.proto_type)
+            value = cpp_node_type(self.map_value) if self.recursive else cpp_base_type(self.map_value, self.is_interned())
+            return cpp_map_type(cpp_base_type(self.map_key, self.is_interned()), value)
+        base = cpp_base_type(self.proto_type, self.is_interned())
+        # std::vector accepts an incomplete item type, only singular recursive fields need a pointer
+        if self.recursive and self.label != "repeated":
+            return cpp_node_type(base)
+        if self.is_string_list():
+            return "ProtobufLight::BasicStringList<std::pmr::polymorphic_allocator<char>>" if OPTIONS.pmr else "ProtobufLight::StringList"
         if self.label == "repeated":
-            return f"std::vector<{base}>"
-        if self.label == "optional":
+            return cpp_vector_type(base, self.inline_capacity())
+        if self.label == "optional" and not self.uses_hasbit():
             return f"std::optional<{base}>"
         return base
 
+    def uses_hasbit(self):
+        # Cold optional fields keep std::optional, the cold struct already only exists once something is set.
+        # A NodePtr is null when absent, it needs no bit either.
+        return (self.label == "optional" and OPTIONS.presence == "hasbits" and not self.cold and not self.in_cold_struct
+                and not self.recursive)
+
+    def is_packed_bool(self):
+        return (OPTIONS.pack_bools and self.proto_type == "bool" and self.label is None
+                and not self.cold and not self.in_cold_struct)
+
+    def inline_capacity(self):
+        # [(protobuflight.inline_capacity) = N] applies to any repeated field. --small-vector skips
+        # message items, which may be recursive and so incomplete where the field is declared.
+        if self.label != "repeated" or self.map_key or self.recursive:
+            return 0
+        if "(protobuflight.inline_capacity)" in self.options:
+            return int(self.options["(protobuflight.inline_capacity)"])
+        if self.proto_type in SCALAR_PROTOS or self.proto_type in ("string", "bytes") or self.proto_type in ENUMS_BY_NAME:
+            return OPTIONS.small_vector
+        return 0
+
+    def is_interned(self):
+        return OPTIONS.intern_strings or self.options.get("(protobuflight.intern)") == "true"
+
+    def is_string_list(self):
+        if self.inline_capacity() > 0:
+            return False
+        # Shared bytes and interned strings already avoid the copy, they stay a vector of handles
+        if OPTIONS.shared_bytes and self.proto_type == "bytes":
+            return False
+        if self.proto_type == "string" and self.is_interned():
+            return False
+        return OPTIONS.compact_strings and self.label == "repeated" and self.proto_type in ("string", "bytes")
+
+    def is_allocator_aware(self, messages):
+        if self.recursive:
+            return True
+        # std::optional is not allocator-aware, its value keeps the default memory resource
+        if self.label == "optional" and not self.uses_hasbit():
+            return False
+        if self.map_key or self.label == "repeated":
+            return True
+        if OPTIONS.shared_bytes and self.proto_type == "bytes":
+            return False
+        if self.proto_type == "string" and self.is_interned():
+            return False
+        return self.proto_type in ("string", "bytes") or self.proto_type in messages
+
     def member_decl(self):
         return f"{self.cpp_type()} {self.name}{{}};"
 
@@ -80,26 +213,44 @@ class Oneof:
         types = []
         for f in self.fields:
             if f.map_key and f.map_value:
-                key = PROTO_TO_CPP.get(f.map_key, f.map_key)
-                val = PROTO_TO_CPP.get(f.map_value, f.map_value)
-                types.append(f"std::map<{key}, {val}>")
+                cpp = cpp_map_type(cpp_base_type(f.map_key), cpp_base_type(f.map_value))
+            elif f.recursive:
+                cpp = cpp_node_type(f.proto_type)
             else:
-                base = PROTO_TO_CPP.get(f.proto_type, f.proto_type)
+                cpp = cpp_base_type(f.proto_type)
                 if f.label == "repeated":
-                    types.append(f"std::vector<{base}>")
-                else:
-                    types.append(base)
+                    cpp = cpp_vector_type(cpp)
+            if is_boxed_alternative(f):
+                cpp = f"ProtobufLight::Box<{cpp}>"
+            types.append(cpp)
         return types
 
+# Candidate enum storage types, smallest first
+NARROW_ENUM_TYPES = [
+    ("uint8_t", 0, 0xFF, 1), ("int8_t", -0x80, 0x7F, 1),
+    ("uint16_t", 0, 0xFFFF, 2), ("int16_t", -0x8000, 0x7FFF, 2),
+]
+
 class Enum:
     def __init__(self, name):
         self.name = name
         self.values = []  # list of (name, number)
+        # Open enums must keep unknown values, so they are never narrowed
+        self.open = False
+
+    def underlying_type(self):
+        if OPTIONS.narrow_enums and not self.open and self.values:
+            low = min(num for _, num in self.values)
+            high = max(num for _, num in self.values)
+            for cpp, min_value, max_value, size in NARROW_ENUM_TYPES:
+                if min_value <= low and high <= max_value:
+                    return cpp, size
+        return "int32_t", 4
 
     def cpp_enum(self, indent=0):
         sp = " " * indent
         lines = []
-        lines.append(f"{sp}enum class {self.name} : int32_t")
+        lines.append(f"{sp}enum class {self.name} : {self.underlying_type()[0]}")
         lines.append(f"{sp}" + "{")
         for val_name, val_num in self.values:
             lines.append(f"{sp}    {val_name} = {val_num},")
@@ -114,7 +265,180 @@ class Message:
         self.nested = []      # can contain Enum and Message
         self.package = None
 
+    def hasbit_fields(self):
+        # Bit i of _has_bits is the presence of the i-th optional field
+        return [fld for fld in self.fields if fld.uses_hasbit()]
+
+    def cold_fields(self):
+        return [fld for fld in self.fields if fld.cold]
+
+    def packed_bool_fields(self):
+        # Bit i of _bool_bits is the value of the i-th packed bool
+        return [fld for fld in self.fields if fld.is_packed_bool()]
+
+    def cold_message(self):
+        # The cold fields, emitted as the nested ColdData struct
+        cold = Message("ColdData")
+        for fld in self.cold_fields():
+            inner = copy.copy(fld)
+            inner.cold = False
+            inner.in_cold_struct = True
+            cold.fields.append(inner)
+        return cold
+
+    def cold_member_type(self):
+        if OPTIONS.pmr:
+            return "ProtobufLight::ColdFields<ColdData, std::pmr::polymorphic_allocator<ColdData>>"
+        return "ProtobufLight::ColdFields<ColdData>"
+
+    def members(self):
+        # (name, declaration, type layout) of every data member, in declaration order
+        members = [(fld.name, fld.member_decl(), field_layout(fld)) for fld in self.fields
+                   if not fld.cold and not fld.is_packed_bool()]
+        bool_fields = self.packed_bool_fields()
+        if bool_fields:
+            words = (len(bool_fields) + 31) // 32
+            members.append(("_bool_bits", f"ProtobufLight::BoolBits<{len(bool_fields)}> _bool_bits{{}};", (4 * words, 4)))
+        if self.cold_fields():
+            members.append(("_cold", f"{self.cold_member_type()} _cold{{}};", (16, 8) if OPTIONS.pmr else (8, 8)))
+        for oneof in self.oneofs:
+            vt = oneof.variant_type_list()
+            if vt:
+                joined = ", ".join(vt)
+                decl = f"std::variant<std::monostate, {joined}> {oneof.name}{{ std::monostate{{}} }};"
+                members.append((oneof.name, decl, oneof_layout(oneof)))
+        hasbit_fields = self.hasbit_fields()
+        if hasbit_fields:
+            words = (len(hasbit_fields) + 31) // 32
+            members.append(("_has_bits", f"ProtobufLight::HasBits<{len(hasbit_fields)}> _has_bits{{}};", (4 * words, 4)))
+        return members
+
+    def ordered_members(self):
+        # Wire order lives in ForEachField, so members can be laid out freely.
+        # Sizes are multiples of alignments, decreasing alignment leaves no padding between members.
+        members = self.members()
+        if OPTIONS.layout == "packed":
+            members.sort(key=lambda m: -m[2][1])
+        return members
+
+# ---- Layout estimation -----------------------------------------------------
+# (size, alignment) estimates for a 64-bit libstdc++ target, only used to order members and to report padding.
+SCALAR_LAYOUT = {
+    "double": (8, 8), "float": (4, 4), "int32_t": (4, 4), "int64_t": (8, 8),
+    "uint32_t": (4, 4), "uint64_t": (8, 8), "bool": (1, 1),
+}
+
+def align_up(value, alignment):
+    return (value + alignment - 1) // alignment * alignment
+
+def struct_layout(layouts):
+    offset = 0
+    alignment = 1
+    for size, align in layouts:
+        offset = align_up(offset, align) + size
+        alignment = max(alignment, align)
+    # An empty struct still has a size of 1
+    return (max(align_up(offset, alignment), 1), alignment)
+
+def base_layout(proto_type, intern=False):
+    cpp = PROTO_TO_CPP.get(proto_type, proto_type)
+    if cpp in SCALAR_LAYOUT:
+        return SCALAR_LAYOUT[cpp]
+    if proto_type == "string" and (intern or OPTIONS.intern_strings):
+        # Pointer into the intern table
+        return (8, 8)
+    if OPTIONS.shared_bytes and proto_type == "bytes":
+        # Owner shared_ptr, data pointer and size
+        return (32, 8)
+    if proto_type in ("string", "bytes"):
+        return (40, 8) if OPTIONS.pmr else (32, 8)
+    if proto_type in ENUMS_BY_NAME:
+        size = ENUMS_BY_NAME[proto_type].underlying_type()[1]
+        return (size, size)
+    if proto_type in MESSAGES_BY_NAME:
+        return message_layout(MESSAGES_BY_NAME[proto_type])
+    # Imported message, size unknown
+    return (8, 8)
+
+def field_layout(fld):
+    if fld.recursive and fld.label != "repeated" and not fld.map_key:
+        # Node pointer, and the memory resource with --pmr
+        return (16, 8) if OPTIONS.pmr else (8, 8)
+    if fld.map_key and fld.map_value:
+        if OPTIONS.map == "flat":
+            # Sorted vector, its comparator and sorted flag
+            return (40, 8) if OPTIONS.pmr else (32, 8)
+        if OPTIONS.map == "hash":
+            return (64, 8) if OPTIONS.pmr else (56, 8)
+        return (56, 8) if OPTIONS.pmr else (48, 8)
+    if fld.label == "repeated":
+        size = 32 if OPTIONS.pmr else 24
+        if OPTIONS.pack_bools and fld.proto_type == "bool":
+            # BoolVector keeps its bit count next to the word vector
+            size += 8
+        elif fld.is_string_list():
+            # Byte blob and offset vectors
+            size *= 2
+        elif fld.inline_capacity() > 0:
+            # Pointer, size and capacity, then the inline elements
+            item_size, item_align = base_layout(fld.proto_type, fld.is_interned())
+            size = (32 if OPTIONS.pmr else 24) + fld.inline_capacity() * item_size
+            return (align_up(size, max(item_align, 8)), max(item_align, 8))
+        return (size, 8)
+    size, align = base_layout(fld.proto_type, fld.is_interned())
+    if fld.label == "optional" and not fld.uses_hasbit():
+        return (align_up(size + 1, align), align)
+    return (size, align)
+
+def is_boxed_alternative(fld):
+    # A boxed alternative only costs the variant a pointer, recursive ones already are a NodePtr
+    return OPTIONS.box_threshold > 0 and not fld.recursive and field_layout(fld)[0] > OPTIONS.box_threshold
+
+def oneof_layout(oneof):
+    alternatives = [(8, 8) if is_boxed_alternative(fld) else field_layout(fld) for fld in oneof.fields]
+    size = max(s for s, _ in alternatives)
+    align = max(a for _, a in alternatives)
+    # The variant index is stored after the largest alternative
+    return (align_up(size + 1, align), align)
+
+def message_layout(msg):
+    return struct_layout([m[2] for m in msg.ordered_members()])
+
+def padding_report(msg, prefix=""):
+    lines = []
+    name = prefix + msg.name
+    layouts = [m[2] for m in msg.ordered_members()]
+    size, _ = struct_layout(layouts)
+    declared_size, _ = struct_layout([m[2] for m in msg.members()])
+    padding = size - sum(s for s, _ in layouts)
+    line = f"  {name}: sizeof ~{size} bytes, {padding} bytes of padding"
+    if declared_size != size:
+        line += f" (declaration order: ~{declared_size} bytes)"
+    lines.append(line)
+    for n in msg.nested:
+        if isinstance(n, Message):
+            lines.extend(padding_report(n, name + "::"))
+    return lines
+
 # ---- Parsing logic ---------------------------------------------------------
+def parse_field_options(text):
+    # [packed = true, (protobuflight.cold) = true] -> {"packed": "true", "(protobuflight.cold)": "true"}
+    options = {}
+    if text:
+        for option in text.split(","):
+            key, _, value = option.partition("=")
+            options[key.strip()] = value.strip()
+    return options
+
+def read_cold_fields(path: Path):
+    # One "Message.field" (or "Outer.Inner.field") per line, '#' starts a comment
+    fields = set()
+    for line in path.read_text(encoding="utf-8").splitlines():
+        line = line.split("#", 1)[0].strip()
+        if line:
+            fields.add(line)
+    return fields
+
 def parse_proto_file(path: Path, visited=None):
     if visited is None:
         visited = set()
@@ -182,6 +506,11 @@ def parse_proto_file(path: Path, visited=None):
             continue
 
         if stack and isinstance(stack[-1], Enum):
+            eo = ENUM_OPTION_RE.search(line)
+            if eo:
+                if eo.group("name") == "(protobuflight.open_enum)":
+                    stack[-1].open = eo.group("value") == "true"
+                continue
             ef = ENUM_FIELD_RE.search(line)
             if ef:
                 stack[-1].values.append((ef.group("name"), int(ef.group("num"))))
@@ -196,6 +525,7 @@ def parse_proto_file(path: Path, visited=None):
                 typ = fm.group("type")
                 name = fm.group("name")
                 number = fm.group("number")
+                options = parse_field_options(fm.group("options"))
 
                 if isinstance(context, Oneof):
                     if map_key and map_value:
@@ -210,6 +540,9 @@ def parse_proto_file(path: Path, visited=None):
                                     map_key=map_key, map_value=map_value)
                     else:
                         fld = Field(name=name, proto_type=typ, number=number, label=label)
+                    fld.options = options
+                    field_path = ".".join(m.name for m in stack if isinstance(m, Message)) + "." + name
+                    fld.cold = options.get("(protobuflight.cold)") == "true" or field_path in OPTIONS.cold_fields
                     context.fields.append(fld)
 
     # Add top-level enums to PROTO_TO_CPP so references to them are recognized
@@ -219,11 +552,18 @@ def parse_proto_file(path: Path, visited=None):
     return messages, enums, imports
 
 # ---- Code generation -------------------------------------------------------
-def emit_message(msg: Message, f, indent=0):
+def emit_message(msg: Message, f, indent=0, methods=True):
     sp = " " * indent
     # struct header
     f.write(f"{sp}struct {msg.name}\n{sp}{{\n")
 
+    # nested messages referenced through a NodePtr before their definition
+    for n in msg.nested:
+        if isinstance(n, Message) and n.name in RECURSIVE_TARGETS:
+            f.write(f"{sp}    struct {n.name};\n")
+    if any(isinstance(n, Message) and n.name in RECURSIVE_TARGETS for n in msg.nested):
+        f.write("\n")
+
     # nested types
     for n in msg.nested:
         if isinstance(n, Enum):
@@ -232,25 +572,179 @@ def emit_message(msg: Message, f, indent=0):
             emit_message(n, f, indent+4)
             f.write("\n")
 
-    # fields
-    for fld in msg.fields:
-        f.write(f"{sp}    {fld.member_decl()}\n")
-
-    # oneofs
-    for oneof in msg.oneofs:
-        vt = oneof.variant_type_list()
-        if vt:
-            joined = ", ".join(vt)
-            f.write(f"{sp}    std::variant<std::monostate, {joined}> {oneof.name}{{ std::monostate{{}} }};\n")
+    if msg.cold_fields():
+        # Rarely set fields, allocated on first write so they don't share cache lines with the hot ones
+        emit_message(msg.cold_message(), f, indent+4, methods=False)
+        f.write("\n")
+
+    if OPTIONS.pmr:
+        f.write(f"{sp}    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;\n\n")
+
+    # fields, oneofs and presence bits
+    for _, decl, _ in msg.ordered_members():
+        f.write(f"{sp}    {decl}\n")
+
+    hasbit_fields = msg.hasbit_fields()
+
+    if OPTIONS.pmr:
+        emit_allocator_constructors(msg, f, indent)
+
+    if hasbit_fields:
+        f.write("\n")
+        for bit, fld in enumerate(hasbit_fields):
+            f.write(f"{sp}    bool has_{fld.name}() const {{ return _has_bits.Test({bit}); }}\n")
+            f.write(f"{sp}    void set_{fld.name}({fld.cpp_type()} value) {{ {fld.name} = std::move(value); _has_bits.Set({bit}); }}\n")
+            f.write(f"{sp}    void clear_{fld.name}() {{ {fld.name} = {{}}; _has_bits.Reset({bit}); }}\n")
+
+    bool_fields = msg.packed_bool_fields()
+    if bool_fields:
+        f.write("\n")
+        for bit, fld in enumerate(bool_fields):
+            f.write(f"{sp}    bool {fld.name}() const {{ return _bool_bits.Test({bit}); }}\n")
+            f.write(f"{sp}    void set_{fld.name}(bool value) {{ _bool_bits.Assign({bit}, value); }}\n")
+
+    cold_fields = msg.cold_fields()
+    if cold_fields:
+        f.write("\n")
+        for fld in cold_fields:
+            f.write(f"{sp}    const {fld.cpp_type()}& {fld.name}() const {{ return _cold.Get().{fld.name}; }}\n")
+            f.write(f"{sp}    {fld.cpp_type()}& mutable_{fld.name}() {{ return _cold.Mutable().{fld.name}; }}\n")
+            f.write(f"{sp}    void set_{fld.name}({fld.cpp_type()} value) {{ _cold.Mutable().{fld.name} = std::move(value); }}\n")
+
+    if not methods:
+        f.write(f"{sp}}};\n")
+        return
 
     # methods
     f.write(f"""
-{sp}    size_t GetByteSize() const {{ return ProtobufLight::Reflection::SerializedStructSize(*this); }}
-{sp}    bool ParseFromArray(const uint8_t* buffer, size_t size) {{ return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }}
+{sp}    constexpr size_t GetByteSize() const {{ return ProtobufLight::Reflection::SerializedStructSize(*this); }}
+{sp}    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) {{ return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }}
 {sp}    std::string SerializeAsString() const {{ std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }}
 {sp}}};
 """)
 
+def emit_allocator_constructors(msg: Message, f, indent=0):
+    # Uses-allocator construction: containers propagate their memory resource to the messages they hold
+    sp = " " * indent
+    name = msg.name
+    aware = [fld.name for fld in msg.fields if not fld.cold and fld.is_allocator_aware(MESSAGE_NAMES)]
+    if msg.cold_fields():
+        aware.append("_cold")
+    # Initializers follow the member order
+    members = [m[0] for m in msg.ordered_members()]
+
+    def init_list(items):
+        return (" : " + ", ".join(items)) if items else ""
+
+    alloc_init = init_list([f"{m}(alloc)" for m in aware])
+    copy_init = init_list([f"{m}(other.{m}, alloc)" if m in aware else f"{m}(other.{m})" for m in members])
+    move_init = init_list([f"{m}(std::move(other.{m}), alloc)" if m in aware else f"{m}(std::move(other.{m}))" for m in members])
+
+    f.write(f"""
+{sp}    {name}() = default;
+{sp}    explicit {name}(const allocator_type& alloc){alloc_init} {{}}
+{sp}    {name}(const {name}& other, const allocator_type& alloc){copy_init} {{}}
+{sp}    {name}({name}&& other, const allocator_type& alloc){move_init} {{}}
+{sp}    {name}(const {name}&) = default;
+{sp}    {name}({name}&&) = default;
+{sp}    {name}& operator=(const {name}&) = default;
+{sp}    {name}& operator=({name}&&) = default;
+""")
+
+def collect_message_names(messages):
+    for msg in messages:
+        MESSAGE_NAMES.add(msg.name)
+        MESSAGES_BY_NAME[msg.name] = msg
+        ENUMS_BY_NAME.update((n.name, n) for n in msg.nested if isinstance(n, Enum))
+        collect_message_names([n for n in msg.nested if isinstance(n, Message)])
+
+def message_fields(msg):
+    # Plain and oneof fields
+    return msg.fields + [fld for oneof in msg.oneofs for fld in oneof.fields]
+
+def referenced_messages(msg):
+    names = set()
+    for fld in message_fields(msg):
+        target = fld.map_value if fld.map_key else fld.proto_type
+        if target in MESSAGES_BY_NAME:
+            names.add(target)
+    return names
+
+def mark_recursive_fields():
+    # A message field is recursive when the field's message leads back to the message holding it.
+    # Such fields are stored behind a NodePtr, which only needs a declaration of the message.
+    reachable = {}
+    for name in MESSAGES_BY_NAME:
+        seen = set()
+        pending = list(referenced_messages(MESSAGES_BY_NAME[name]))
+        while pending:
+            current = pending.pop()
+            if current not in seen:
+                seen.add(current)
+                pending.extend(referenced_messages(MESSAGES_BY_NAME[current]))
+        reachable[name] = seen
+
+    for name, msg in MESSAGES_BY_NAME.items():
+        for fld in message_fields(msg):
+            target = fld.map_value if fld.map_key else fld.proto_type
+            if target in MESSAGES_BY_NAME and name in reachable[target]:
+                fld.recursive = True
+                RECURSIVE_TARGETS.add(target)
+
+def field_ref(msg, fld, full_name):
+    hasbit_fields = msg.hasbit_fields()
+    if fld in hasbit_fields:
+        return f"ProtobufLight::MakeHasBitRef(obj.{fld.name}, obj._has_bits, {hasbit_fields.index(fld)})"
+    bool_fields = msg.packed_bool_fields()
+    if fld in bool_fields:
+        return f"ProtobufLight::MakeBoolRef(obj._bool_bits, {bool_fields.index(fld)})"
+    if fld.cold:
+        return f"ProtobufLight::MakeColdRef(obj._cold, &{full_name}::ColdData::{fld.name})"
+    return f"obj.{fld.name}"
+
+def emit_present_fields(msg: Message, f, full_name):
+    # Same fields and order as ForEachField, but runs of optional fields sharing a _has_bits word
+    # are visited by scanning the set bits, so absent fields cost nothing.
+    hasbit_fields = msg.hasbit_fields()
+    f.write("\n    template<typename Obj, typename Callback>\n")
+    f.write("    static constexpr void ForEachPresentField(Obj& obj, Callback&& cb) {\n")
+
+    fields = [fld for fld in msg.fields if fld.number is not None]
+    i = 0
+    while i < len(fields):
+        fld = fields[i]
+        if fld not in hasbit_fields:
+            f.write(f'        cb({field_ref(msg, fld, full_name)}, FieldMeta<{fld.number}>{{"{fld.name}"}});\n')
+            i += 1
+            continue
+
+        run = [fld]
+        word = hasbit_fields.index(fld) // 32
+        while i + len(run) < len(fields) and fields[i + len(run)] in hasbit_fields \
+                and hasbit_fields.index(fields[i + len(run)]) // 32 == word:
+            run.append(fields[i + len(run)])
+        i += len(run)
+
+        first_bit = hasbit_fields.index(run[0]) % 32
+        mask = ((1 << len(run)) - 1) << first_bit
+        f.write(f"        for (uint32_t bits = obj._has_bits.Word({word}) & 0x{mask:x}u; bits != 0; bits &= bits - 1)\n")
+        f.write("        {\n")
+        f.write("            switch (ProtobufLight::CountTrailingZeros(bits))\n")
+        f.write("            {\n")
+        for run_fld in run:
+            bit = hasbit_fields.index(run_fld)
+            f.write(f'                case {bit % 32}: cb({field_ref(msg, run_fld, full_name)}, FieldMeta<{run_fld.number}>{{"{run_fld.name}"}}); break;\n')
+        f.write("            }\n")
+        f.write("        }\n")
+
+    for oneof in msg.oneofs:
+        if not oneof.fields:
+            continue
+        nums = ",".join(str(f.number) for f in oneof.fields)
+        f.write(f'        cb(obj.{oneof.name}, FieldMeta<{nums}>{{"{oneof.name}"}});\n')
+
+    f.write("    }\n")
+
 def emit_traits(msg: Message, f, prefix=""):
     full_name = f"{prefix}::{msg.name}" if prefix else msg.name
 
@@ -258,12 +752,13 @@ def emit_traits(msg: Message, f, prefix=""):
     f.write(f"struct ProtobufLight::Reflection::ProtobufTrait<{full_name}>\n")
     f.write("{\n")
     f.write("    template<typename Obj, typename Callback>\n")
-    f.write("    static void ForEachField(Obj& obj, Callback&& cb) {\n")
+    f.write("    static constexpr void ForEachField(Obj& obj, Callback&& cb) {\n")
 
+    hasbit_fields = msg.hasbit_fields()
     for fld in msg.fields:
         if fld.number is None:
             continue
-        f.write(f'        cb(obj.{fld.name}, FieldMeta<{fld.number}>{{"{fld.name}"}});\n')
+        f.write(f'        cb({field_ref(msg, fld, full_name)}, FieldMeta<{fld.number}>{{"{fld.name}"}});\n')
 
     for oneof in msg.oneofs:
         if not oneof.fields:
@@ -271,48 +766,167 @@ def emit_traits(msg: Message, f, prefix=""):
         nums = ",".join(str(f.number) for f in oneof.fields)
         f.write(f'        cb(obj.{oneof.name}, FieldMeta<{nums}>{{"{oneof.name}"}});\n')
 
-    f.write("    }\n};\n\n")
+    f.write("    }\n")
+
+    if hasbit_fields:
+        emit_present_fields(msg, f, full_name)
+
+    f.write("};\n\n")
 
     # recurse into nested messages
     for n in msg.nested:
         if isinstance(n, Message):
             emit_traits(n, f, prefix=full_name)
 
+def column_fields(msg: Message):
+    # Singular scalar, enum and string fields, the ones a flat column can hold
+    return [fld for fld in msg.fields
+            if fld.label != "repeated" and not fld.map_key and fld.number is not None
+            and (fld.proto_type in SCALAR_PROTOS or fld.proto_type in ("string", "bytes") or fld.proto_type in ENUMS_BY_NAME)]
+
+def column_type(fld):
+    if fld.proto_type in ("string", "bytes"):
+        return "ProtobufLight::StringList"
+    if fld.proto_type == "bool":
+        return "ProtobufLight::BoolVector"
+    return f"std::vector<{PROTO_TO_CPP.get(fld.proto_type, fld.proto_type)}>"
+
+def emit_columns(msg: Message, f):
+    f.write(f"// Struct-of-arrays {msg.name} rows, filled by ProtobufLight::Reflection::ParseColumns\n")
+    f.write(f"struct {msg.name}Columns\n{{\n")
+    f.write("    size_t rows{};\n")
+    for fld in column_fields(msg):
+        f.write(f"    {column_type(fld)} {fld.name}{{}};\n")
+        f.write(f"    ProtobufLight::BoolVector {fld.name}_present{{}};\n")
+    f.write("};\n\n")
+
+def emit_columns_traits(msg: Message, f):
+    f.write("template<>\n")
+    f.write(f"struct ProtobufLight::Reflection::ColumnsTrait<{msg.name}Columns>\n")
+    f.write("{\n")
+    f.write(f"    using Row = {msg.name};\n\n")
+    f.write("    template<typename Obj, typename Callback>\n")
+    f.write("    static void ForEachColumn(Obj& obj, Callback&& cb) {\n")
+    for fld in column_fields(msg):
+        f.write(f'        cb(obj.{fld.name}, obj.{fld.name}_present, FieldMeta<{fld.number}>{{"{fld.name}"}});\n')
+    f.write("    }\n")
+    f.write("};\n\n")
+
 def generate_header(messages: dict, enums: dict, imports, out_path: Path):
     with out_path.open("w", encoding="utf-8") as f:
         f.write("// Auto-generated from .proto\n")
         f.write("#pragma once\n\n")
         f.write("#include <ProtobufLight/ProtobufLightReflection.hpp>\n\n")
+        if OPTIONS.columns:
+            f.write("#include <ProtobufLight/ProtobufLightColumns.hpp>\n\n")
+        if OPTIONS.pmr:
+            f.write("#include <memory_resource>\n\n")
         if len(imports) > 0:
             for import_ in imports:
                 f.write(f'#include <{import_.replace(".proto",".pb.h")}>\n')
             f.write('\n')
 
+        ENUMS_BY_NAME.update(enums)
+        collect_message_names(messages.values())
+        mark_recursive_fields()
+
         # top-level enums
         for en in enums.values():
             f.write(en.cpp_enum() + "\n\n")
 
+        # recursive messages may be used before their definition
+        forward = [msg.name for msg in messages.values() if msg.name in RECURSIVE_TARGETS]
+        for name in forward:
+            f.write(f"struct {name};\n")
+        if forward:
+            f.write("\n")
+
         # messages
         for msg in messages.values():
             emit_message(msg, f)
             f.write("\n")
 
+        columns = [messages[name] for name in OPTIONS.columns if name in messages]
+        for msg in columns:
+            emit_columns(msg, f)
+
         for msg in messages.values():
             emit_traits(msg, f)
 
+        for msg in columns:
+            emit_columns_traits(msg, f)
+
 def main():
-    if len(sys.argv) != 3:
-        print("Usage: protobuflight_protoc.py <input.proto> <output.hpp>")
-        sys.exit(1)
-    proto_file = Path(sys.argv[1])
-    out_file = Path(sys.argv[2])
+    parser = argparse.ArgumentParser(description="Generates ProtobufLight C++ structs from a .proto file.")
+    parser.add_argument("input", help="input .proto file")
+    parser.add_argument("output", help="output C++ header")
+    parser.add_argument("--pmr", action="store_true",
+                        help="emit allocator-aware structs using std::pmr::string, std::pmr::vector and std::pmr::map")
+    parser.add_argument("--presence", choices=["optional", "hasbits"], default="optional",
+                        help="store optional fields as std::optional, or as plain members with a packed presence bitmask")
+    parser.add_argument("--layout", choices=["declaration", "packed"], default="declaration",
+                        help="keep members in .proto order, or sort them by alignment to minimize padding")
+    parser.add_argument("--layout-report", action="store_true",
+                        help="print the estimated sizeof and padding of every message")
+    parser.add_argument("--cold-fields", metavar="FILE",
+                        help="profile listing one Message.field per line to move into the cold struct, "
+                             "in addition to fields marked [(protobuflight.cold) = true]")
+    parser.add_argument("--narrow-enums", action="store_true",
+                        help="store each enum in the smallest integer type holding its values, "
+                             "enums with option (protobuflight.open_enum) = true keep int32_t")
+    parser.add_argument("--pack-bools", action="store_true",
+                        help="store bool fields as bits of one packed word and repeated bools as ProtobufLight::BoolVector")
+    parser.add_argument("--box-threshold", type=int, default=0, metavar="BYTES",
+                        help="store oneof alternatives whose estimated size is above BYTES in a ProtobufLight::Box")
+    parser.add_argument("--map", choices=["ordered", "flat", "hash"], default="ordered",
+                        help="map fields as std::map, as a sorted vector ProtobufLight::FlatMap, or as std::unordered_map")
+    parser.add_argument("--shared-bytes", action="store_true",
+                        help="store bytes fields as ProtobufLight::SharedBytes, parsing from a shared buffer then slices it instead of copying")
+    parser.add_argument("--compact-strings", action="store_true",
+                        help="store repeated string and bytes fields as ProtobufLight::StringList, one byte blob plus offsets")
+    parser.add_argument("--intern-strings", action="store_true",
+                        help="store every string field as ProtobufLight::InternedString, "
+                             "fields marked [(protobuflight.intern) = true] are interned either way")
+    parser.add_argument("--small-vector", type=int, default=0, metavar="N",
+                        help="store repeated scalar, enum and string fields as ProtobufLight::SmallVector with N inline elements, "
+                             "[(protobuflight.inline_capacity) = N] sets it per field")
+    parser.add_argument("--columns", default="", metavar="MESSAGE[,MESSAGE...]",
+                        help="also emit a struct-of-arrays <Message>Columns companion for these top-level messages, "
+                             "decoded with ProtobufLight::Reflection::ParseColumns")
+    args = parser.parse_args()
+
+    OPTIONS.pmr = args.pmr
+    OPTIONS.presence = args.presence
+    OPTIONS.layout = args.layout
+    OPTIONS.narrow_enums = args.narrow_enums
+    OPTIONS.pack_bools = args.pack_bools
+    OPTIONS.box_threshold = args.box_threshold
+    OPTIONS.map = args.map
+    OPTIONS.shared_bytes = args.shared_bytes
+    OPTIONS.compact_strings = args.compact_strings
+    OPTIONS.intern_strings = args.intern_strings
+    OPTIONS.small_vector = args.small_vector
+    OPTIONS.columns = [name.strip() for name in args.columns.split(",") if name.strip()]
+    if args.cold_fields:
+        OPTIONS.cold_fields = read_cold_fields(Path(args.cold_fields))
+
+    proto_file = Path(args.input)
+    out_file = Path(args.output)
     if not proto_file.exists():
         print(f"Input file not found: {proto_file}")
         sys.exit(1)
 
     messages, enums, imports = parse_proto_file(proto_file)
+    for name in OPTIONS.columns:
+        if name not in messages:
+            print(f"--columns: {name} is not a top-level message of {proto_file}")
+            sys.exit(1)
     generate_header(messages, enums, imports, out_file)
     print(f"Generated {out_file} with messages: {', '.join(messages.keys())} and enums: {', '.join(enums.keys())}")
+    if args.layout_report:
+        print(f"Layout ({OPTIONS.layout}, 64-bit estimate):")
+        for msg in messages.values():
+            print("\n".join(padding_report(msg)))
 
 if __name__ == "__main__":
     main()
@@ -10,125 +10,1779 @@
 
 #include <string>
 #include <string_view>
+#include <algorithm>
+#include <iterator>
+#include <initializer_list>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
 #include <array>
 #include <variant>
 #include <optional>
 #include <type_traits>
+#include <utility>
+#include <tuple>
 #include <stdexcept>
 #include <limits>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <cassert>
 
+#if defined(__has_builtin)
+#  if __has_builtin(__builtin_bit_cast)
+#    define PROTOBUF_LIGHT_HAS_BUILTIN_BIT_CAST 1
+#  endif
+#endif
+#if !defined(PROTOBUF_LIGHT_HAS_BUILTIN_BIT_CAST) && defined(_MSC_VER) && _MSC_VER >= 1927
+#  define PROTOBUF_LIGHT_HAS_BUILTIN_BIT_CAST 1
+#endif
+
 namespace ProtobufLight {
 
-struct ParseError : public std::runtime_error
+struct ParseError : public std::runtime_error
+{
+    explicit ParseError(const std::string& m) : std::runtime_error(m) {}
+    explicit ParseError(const char* m) : std::runtime_error(m) {}
+};
+
+namespace Detail {
+    template<typename, typename = void>
+    struct has_data_and_size : std::false_type {};
+
+    template<typename T>
+    struct has_data_and_size<T, std::void_t<
+        decltype(std::declval<const T&>().data()),
+        decltype(std::declval<const T&>().size())
+    >> : std::true_type {};
+
+    template<typename T>
+    constexpr bool has_data_and_size_v = has_data_and_size<T>::value;
+
+    template<typename T, typename... Ts>
+    constexpr bool is_any_v = (std::is_same_v<T, Ts> || ...);
+
+    template<typename T>
+    constexpr bool is_byte_like_v = is_any_v<T, std::byte, uint8_t, unsigned char, int8_t, signed char, char>;
+
+    template<typename T>
+    struct is_variant : std::false_type {};
+
+    template<typename... Ts>
+    struct is_variant<std::variant<Ts...>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_variant_v = is_variant<T>::value;
+
+    template<typename C, typename = void>
+    struct is_byte_container : std::false_type {};
+
+    template<typename C>
+    struct is_byte_container<C, std::enable_if_t<has_data_and_size_v<C>>> {
+    private:
+        using PtrT = decltype(std::declval<const C&>().data());
+        using ElemT = std::remove_cv_t<std::remove_pointer_t<PtrT>>;
+    public:
+        static constexpr bool value = is_byte_like_v<ElemT>;
+    };
+
+    template<typename C>
+    constexpr bool is_byte_container_v = is_byte_container<C>::value;
+
+    template<typename, typename = void>
+    struct has_push_back_method : std::false_type {};
+
+    template<typename C>
+    struct has_push_back_method<C, std::void_t<
+        decltype(std::declval<C&>().push_back(std::declval<typename C::value_type>()))
+    >> : std::true_type {};
+
+    template<typename C>
+    constexpr bool has_push_back_method_v = has_push_back_method<C>::value;
+
+    template<typename C>
+    constexpr bool is_appendable_byte_container_v = is_byte_container_v<C> && has_push_back_method_v<C>;
+
+    template<typename, typename = void>
+    struct has_resize_method : std::false_type {};
+
+    template<typename C>
+    struct has_resize_method<C, std::void_t<
+        decltype(std::declval<C&>().resize(size_t{})),
+        decltype(*std::declval<C&>().data() = typename C::value_type{})
+    >> : std::true_type {};
+
+    template<typename C>
+    constexpr bool has_resize_method_v = has_resize_method<C>::value;
+
+    // Containers that can be grown once and then written in place, like std::string and std::vector<uint8_t>.
+    template<typename C>
+    constexpr bool is_resizable_byte_container_v = is_appendable_byte_container_v<C> && has_resize_method_v<C>;
+
+    template<typename T>
+    struct is_std_map : std::false_type {};
+
+    template<typename K, typename V, typename Pr, typename Alloc>
+    struct is_std_map<std::map<K, V, Pr, Alloc>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_std_map_v = is_std_map<T>::value;
+
+    template<typename T>
+    struct is_std_unordered_map : std::false_type {};
+
+    template<typename K, typename V, typename Hash, typename Eq, typename Alloc>
+    struct is_std_unordered_map<std::unordered_map<K, V, Hash, Eq, Alloc>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_std_unordered_map_v = is_std_unordered_map<T>::value;
+
+    template<typename T>
+    struct is_std_vector : std::false_type {};
+
+    template<typename T, typename Alloc>
+    struct is_std_vector<std::vector<T, Alloc>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_std_vector_v = is_std_vector<T>::value;
+
+    template<typename T>
+    struct is_std_optional : std::false_type {};
+
+    template<typename T>
+    struct is_std_optional<std::optional<T>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_std_optional_v = is_std_optional<T>::value;
+
+    template<typename MemberT, typename MetaT>
+    constexpr void ValidateFieldmetaVariant() {
+        static_assert(is_variant_v<MemberT>, "Called validate_fieldmeta_variant on non-variant");
+
+        using FirstAlt = std::variant_alternative_t<0, MemberT>;
+        static_assert(std::is_same_v<FirstAlt, std::monostate>,
+            "Oneof variant must have std::monostate as first alternative");
+
+        constexpr size_t variant_size = std::variant_size_v<MemberT>;
+        constexpr size_t expected_numbers = variant_size - 1;
+
+        constexpr auto& nums = MetaT::numbers;
+        static_assert(nums.size() == expected_numbers,
+            "FieldMeta numbers must have exactly variant_size-1 entries for oneof (excluding monostate)");
+    }
+
+    // Builds a T using alloc when T is allocator-aware (std::pmr containers, structs generated with --pmr),
+    // so temporaries moved into a container don't have to be copied to its memory resource.
+    template<typename T, typename Alloc>
+    T MakeUsingAllocator(const Alloc& alloc)
+    {
+        if constexpr (std::uses_allocator_v<T, Alloc>)
+            return T(alloc);
+        else
+            return T{};
+    }
+
+    // Enums generated with --narrow-enums use a smaller underlying type than the int32 of the wire.
+    template<typename E>
+    constexpr bool EnumValueFits(uint64_t wireValue) noexcept
+    {
+        using U = std::underlying_type_t<E>;
+        if constexpr (sizeof(U) >= sizeof(int32_t))
+        {
+            return true;
+        }
+        else if constexpr (std::is_signed_v<U>)
+        {
+            // Negative values are sign extended to 64 bits on the wire
+            const int64_t signedValue = static_cast<int64_t>(wireValue);
+            return signedValue >= std::numeric_limits<U>::min() && signedValue <= std::numeric_limits<U>::max();
+        }
+        else
+        {
+            return wireValue <= std::numeric_limits<U>::max();
+        }
+    }
+
+    // std::bit_cast is C++20, use the compiler builtin so float encoding still works in constant expressions.
+    template<typename To, typename From>
+    constexpr To BitCast(const From& from) noexcept
+    {
+        static_assert(sizeof(To) == sizeof(From), "BitCast requires types of the same size");
+#if defined(PROTOBUF_LIGHT_HAS_BUILTIN_BIT_CAST)
+        return __builtin_bit_cast(To, from);
+#else
+        To to{};
+        std::memcpy(&to, &from, sizeof(To));
+        return to;
+#endif
+    }
+
+} // namespace Detail
+
+// Fixed capacity byte buffer, it can be used as a serialization target in constant expressions.
+// Checked = false drops the capacity check of every appended byte, for writers that proved the
+// capacity beforehand (SerializeToStaticBuffer); an overflow is then only asserted.
+template<size_t N, bool Checked = true>
+class StaticBuffer
+{
+public:
+    using value_type = uint8_t;
+
+    constexpr StaticBuffer() noexcept : _buffer{}, _size(0) {}
+
+    constexpr uint8_t* data() noexcept { return _buffer.data(); }
+    constexpr const uint8_t* data() const noexcept { return _buffer.data(); }
+    constexpr size_t size() const noexcept { return _size; }
+    static constexpr size_t capacity() noexcept { return N; }
+
+    constexpr uint8_t* begin() noexcept { return _buffer.data(); }
+    constexpr const uint8_t* begin() const noexcept { return _buffer.data(); }
+    constexpr uint8_t* end() noexcept { return _buffer.data() + _size; }
+    constexpr const uint8_t* end() const noexcept { return _buffer.data() + _size; }
+
+    // Checked buffers throw std::length_error instead of writing past the array
+    constexpr void push_back(uint8_t value)
+    {
+        if constexpr (Checked)
+        {
+            if (_size >= N)
+                throw std::length_error("StaticBuffer overflow");
+        }
+        else
+        {
+            assert(_size < N && "StaticBuffer overflow");
+        }
+
+        _buffer[_size++] = value;
+    }
+
+    // Only appending is supported, which is all the encoders need.
+    template<typename InputIt>
+    constexpr uint8_t* insert([[maybe_unused]] const uint8_t* pos, InputIt first, InputIt last)
+    {
+        assert(pos == end() && "StaticBuffer only supports inserting at the end");
+        uint8_t* it = end();
+        for (; first != last; ++first)
+            push_back(static_cast<uint8_t>(*first));
+
+        return it;
+    }
+
+    constexpr void clear() noexcept { _size = 0; }
+
+    constexpr const std::array<uint8_t, N>& array() const noexcept { return _buffer; }
+
+private:
+    std::array<uint8_t, N> _buffer;
+    size_t _size;
+};
+
+// Non owning byte buffer over a pre-sized memory region, encoders append into it without reallocating.
+class SpanBuffer
+{
+public:
+    using value_type = uint8_t;
+
+    constexpr SpanBuffer(uint8_t* data, size_t capacity) noexcept : _data(data), _size(0), _capacity(capacity) {}
+
+    constexpr uint8_t* data() noexcept { return _data; }
+    constexpr const uint8_t* data() const noexcept { return _data; }
+    constexpr size_t size() const noexcept { return _size; }
+    constexpr size_t capacity() const noexcept { return _capacity; }
+
+    constexpr uint8_t* begin() noexcept { return _data; }
+    constexpr const uint8_t* begin() const noexcept { return _data; }
+    constexpr uint8_t* end() noexcept { return _data + _size; }
+    constexpr const uint8_t* end() const noexcept { return _data + _size; }
+
+    // Throws std::length_error instead of writing past the region
+    constexpr void push_back(uint8_t value)
+    {
+        if (_size >= _capacity)
+            throw std::length_error("SpanBuffer overflow");
+
+        _data[_size++] = value;
+    }
+
+    template<typename InputIt>
+    uint8_t* insert([[maybe_unused]] const uint8_t* pos, InputIt first, InputIt last)
+    {
+        assert(pos == end() && "SpanBuffer only supports inserting at the end");
+        uint8_t* it = end();
+        if constexpr (std::is_pointer_v<InputIt>)
+        {
+            const size_t length = static_cast<size_t>(last - first);
+            if (length > _capacity - _size)
+                throw std::length_error("SpanBuffer overflow");
+
+            if (length > 0)
+                std::memcpy(it, first, length);
+
+            _size += length;
+        }
+        else
+        {
+            for (; first != last; ++first)
+                push_back(static_cast<uint8_t>(*first));
+        }
+        return it;
+    }
+
+private:
+    uint8_t* _data;
+    size_t _size;
+    size_t _capacity;
+};
+
+constexpr uint32_t CountTrailingZeros(uint32_t value) noexcept
+{
+    assert(value != 0 && "CountTrailingZeros is undefined for 0");
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<uint32_t>(__builtin_ctz(value));
+#else
+    uint32_t count = 0;
+    while ((value & 1u) == 0)
+    {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+#endif
+}
+
+// Packed presence bits of the optional fields of a message generated with --presence=hasbits.
+template<size_t N>
+class HasBits
+{
+public:
+    static constexpr size_t WordCount = (N + 31) / 32;
+
+    constexpr bool Test(size_t bit) const noexcept { return (_words[bit / 32] >> (bit % 32)) & 1u; }
+    constexpr void Set(size_t bit) noexcept { _words[bit / 32] |= uint32_t(1) << (bit % 32); }
+    constexpr void Reset(size_t bit) noexcept { _words[bit / 32] &= ~(uint32_t(1) << (bit % 32)); }
+
+    constexpr void Assign(size_t bit, bool value) noexcept
+    {
+        if (value)
+            Set(bit);
+        else
+            Reset(bit);
+    }
+    constexpr uint32_t Word(size_t word) const noexcept { return _words[word]; }
+    constexpr void Clear() noexcept { _words = {}; }
+
+    constexpr bool operator==(const HasBits& other) const noexcept { return _words == other._words; }
+    constexpr bool operator!=(const HasBits& other) const noexcept { return !(*this == other); }
+
+private:
+    std::array<uint32_t, WordCount> _words{};
+};
+
+// What ForEachField hands out for a hasbit optional field: the plain member and its presence bit,
+// so reflection can treat it like a std::optional.
+template<typename ValueT, typename BitsT>
+class HasBitRef
+{
+public:
+    using value_type = std::remove_const_t<ValueT>;
+
+    constexpr HasBitRef(ValueT& value, BitsT& bits, size_t bit) noexcept : _value(value), _bits(bits), _bit(bit) {}
+
+    constexpr bool Has() const noexcept { return _bits.Test(_bit); }
+    constexpr ValueT& Value() const noexcept { return _value; }
+    constexpr void Set() const noexcept { _bits.Set(_bit); }
+    // Drops the presence bit only, the value keeps its storage for the next Set
+    constexpr void Unset() const noexcept { _bits.Reset(_bit); }
+
+    constexpr void Clear() const
+    {
+        _value = value_type{};
+        _bits.Reset(_bit);
+    }
+
+private:
+    ValueT& _value;
+    BitsT& _bits;
+    size_t _bit;
+};
+
+template<typename ValueT, typename BitsT>
+constexpr HasBitRef<ValueT, BitsT> MakeHasBitRef(ValueT& value, BitsT& bits, size_t bit) noexcept
+{
+    return HasBitRef<ValueT, BitsT>(value, bits, bit);
+}
+
+// Values of the bool fields of a message generated with --pack-bools.
+template<size_t N>
+using BoolBits = HasBits<N>;
+
+// What ForEachField hands out for a packed bool field.
+template<typename BitsT>
+class BoolRef
+{
+public:
+    constexpr BoolRef(BitsT& bits, size_t bit) noexcept : _bits(bits), _bit(bit) {}
+
+    constexpr bool Get() const noexcept { return _bits.Test(_bit); }
+    constexpr void Set(bool value) const noexcept { _bits.Assign(_bit, value); }
+    constexpr void Clear() const noexcept { _bits.Reset(_bit); }
+
+private:
+    BitsT& _bits;
+    size_t _bit;
+};
+
+template<typename BitsT>
+constexpr BoolRef<BitsT> MakeBoolRef(BitsT& bits, size_t bit) noexcept
+{
+    return BoolRef<BitsT>(bits, bit);
+}
+
+// Repeated bool storage, one bit per value instead of std::vector<bool>'s proxy based interface.
+template<typename Alloc = std::allocator<uint64_t>>
+class BasicBoolVector
+{
+public:
+    using value_type = bool;
+    using allocator_type = Alloc;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = bool;
+
+        const_iterator(const BasicBoolVector* vector, size_t index) noexcept : _vector(vector), _index(index) {}
+
+        bool operator*() const { return (*_vector)[_index]; }
+        const_iterator& operator++() noexcept { ++_index; return *this; }
+        const_iterator operator++(int) noexcept { const_iterator it = *this; ++_index; return it; }
+        bool operator==(const const_iterator& other) const noexcept { return _index == other._index; }
+        bool operator!=(const const_iterator& other) const noexcept { return _index != other._index; }
+
+    private:
+        const BasicBoolVector* _vector;
+        size_t _index;
+    };
+
+    BasicBoolVector() = default;
+    explicit BasicBoolVector(const Alloc& alloc) : _words(alloc) {}
+    BasicBoolVector(std::initializer_list<bool> values)
+    {
+        reserve(values.size());
+        for (bool value : values)
+            push_back(value);
+    }
+    BasicBoolVector(const BasicBoolVector& other, const Alloc& alloc) : _words(other._words, alloc), _size(other._size) {}
+    BasicBoolVector(BasicBoolVector&& other, const Alloc& alloc) : _words(std::move(other._words), alloc), _size(std::exchange(other._size, 0)) {}
+    BasicBoolVector(const BasicBoolVector&) = default;
+    BasicBoolVector(BasicBoolVector&& other) noexcept : _words(std::move(other._words)), _size(std::exchange(other._size, 0)) {}
+    BasicBoolVector& operator=(const BasicBoolVector&) = default;
+    BasicBoolVector& operator=(BasicBoolVector&& other)
+    {
+        _words = std::move(other._words);
+        _size = std::exchange(other._size, 0);
+        return *this;
+    }
+
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    void reserve(size_t count) { _words.reserve(WordCount(count)); }
+    void clear() noexcept { _words.clear(); _size = 0; }
+    // Heap bytes held, including reserved capacity
+    size_t CapacityBytes() const noexcept { return _words.capacity() * sizeof(uint64_t); }
+    allocator_type get_allocator() const noexcept { return _words.get_allocator(); }
+
+    bool operator[](size_t index) const { return (_words[index / 64] >> (index % 64)) & 1u; }
+
+    void Set(size_t index, bool value)
+    {
+        const uint64_t mask = uint64_t(1) << (index % 64);
+        if (value)
+            _words[index / 64] |= mask;
+        else
+            _words[index / 64] &= ~mask;
+    }
+
+    void push_back(bool value) { AppendBits(value ? 1u : 0u, 1); }
+
+    void pop_back() noexcept
+    {
+        --_size;
+        if (_size % 64 == 0)
+            _words.pop_back();
+        else
+            _words.back() &= (uint64_t(1) << (_size % 64)) - 1;
+    }
+
+    // Appends the count low bits of bits, bit 0 first. Used by the packed decoder to add 8 values at once.
+    void AppendBits(uint64_t bits, size_t count)
+    {
+        assert(count <= 64 && "AppendBits appends at most one word");
+        if (count == 0)
+            return;
+
+        if (count < 64)
+            bits &= (uint64_t(1) << count) - 1;
+
+        const size_t offset = _size % 64;
+        if (offset == 0)
+        {
+            _words.push_back(bits);
+        }
+        else
+        {
+            _words.back() |= bits << offset;
+            if (offset + count > 64)
+                _words.push_back(bits >> (64 - offset));
+        }
+        _size += count;
+    }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, _size); }
+
+    bool operator==(const BasicBoolVector& other) const noexcept { return _size == other._size && _words == other._words; }
+    bool operator!=(const BasicBoolVector& other) const noexcept { return !(*this == other); }
+
+private:
+    static size_t WordCount(size_t count) noexcept { return (count + 63) / 64; }
+
+    // Bits past _size are always 0, so words compare equal when the values do
+    std::vector<uint64_t, Alloc> _words;
+    size_t _size = 0;
+};
+
+using BoolVector = BasicBoolVector<>;
+
+// Repeated string or bytes storage: every element is appended to one byte blob and only its end offset
+// is stored, about 4 + N bytes per element instead of a 32 byte std::string plus its heap block.
+// Elements are read back as std::string_view, valid until the list is modified.
+template<typename Alloc = std::allocator<char>>
+class BasicStringList
+{
+    using OffsetAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<uint32_t>;
+
+public:
+    using value_type = std::string_view;
+    using allocator_type = Alloc;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::string_view;
+
+        const_iterator(const BasicStringList* list, size_t index) noexcept : _list(list), _index(index) {}
+
+        std::string_view operator*() const { return (*_list)[_index]; }
+        std::string_view operator[](difference_type n) const { return (*_list)[_index + n]; }
+        const_iterator& operator++() noexcept { ++_index; return *this; }
+        const_iterator operator++(int) noexcept { const_iterator it = *this; ++_index; return it; }
+        const_iterator& operator--() noexcept { --_index; return *this; }
+        const_iterator operator--(int) noexcept { const_iterator it = *this; --_index; return it; }
+        const_iterator& operator+=(difference_type n) noexcept { _index += n; return *this; }
+        const_iterator& operator-=(difference_type n) noexcept { _index -= n; return *this; }
+        const_iterator operator+(difference_type n) const noexcept { return const_iterator(_list, _index + n); }
+        const_iterator operator-(difference_type n) const noexcept { return const_iterator(_list, _index - n); }
+        difference_type operator-(const const_iterator& other) const noexcept { return difference_type(_index) - difference_type(other._index); }
+        bool operator==(const const_iterator& other) const noexcept { return _index == other._index; }
+        bool operator!=(const const_iterator& other) const noexcept { return _index != other._index; }
+        bool operator<(const const_iterator& other) const noexcept { return _index < other._index; }
+
+    private:
+        const BasicStringList* _list;
+        size_t _index;
+    };
+
+    BasicStringList() = default;
+    explicit BasicStringList(const Alloc& alloc) : _bytes(alloc), _ends(OffsetAlloc(alloc)) {}
+    BasicStringList(std::initializer_list<std::string_view> values)
+    {
+        for (std::string_view value : values)
+            push_back(value);
+    }
+    BasicStringList(const BasicStringList& other, const Alloc& alloc) : _bytes(other._bytes, alloc), _ends(other._ends, OffsetAlloc(alloc)) {}
+    BasicStringList(BasicStringList&& other, const Alloc& alloc) : _bytes(std::move(other._bytes), alloc), _ends(std::move(other._ends), OffsetAlloc(alloc)) {}
+    BasicStringList(const BasicStringList&) = default;
+    BasicStringList(BasicStringList&&) = default;
+    BasicStringList& operator=(const BasicStringList&) = default;
+    BasicStringList& operator=(BasicStringList&&) = default;
+
+    size_t size() const noexcept { return _ends.size(); }
+    bool empty() const noexcept { return _ends.empty(); }
+    // Total length of all elements
+    size_t ByteSize() const noexcept { return _bytes.size(); }
+    void reserve(size_t count, size_t bytes = 0) { _ends.reserve(count); _bytes.reserve(bytes); }
+    void clear() noexcept { _bytes.clear(); _ends.clear(); }
+    // Heap bytes held by the blob and the offsets, including reserved capacity
+    size_t CapacityBytes() const noexcept { return _bytes.capacity() + _ends.capacity() * sizeof(uint32_t); }
+    allocator_type get_allocator() const noexcept { return _bytes.get_allocator(); }
+
+    std::string_view operator[](size_t index) const
+    {
+        const uint32_t begin = index == 0 ? 0 : _ends[index - 1];
+        return std::string_view(_bytes.data() + begin, _ends[index] - begin);
+    }
+
+    std::string_view at(size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range("StringList index out of range");
+
+        return (*this)[index];
+    }
+
+    std::string_view back() const { return (*this)[size() - 1]; }
+
+    // Throws std::length_error once the blob would pass the 4 GiB the offsets can address
+    void push_back(std::string_view value)
+    {
+        if (value.size() > std::numeric_limits<uint32_t>::max() - _bytes.size())
+            throw std::length_error("StringList holds at most 4 GiB of bytes");
+
+        _bytes.insert(_bytes.end(), value.begin(), value.end());
+        _ends.push_back(static_cast<uint32_t>(_bytes.size()));
+    }
+
+    void pop_back() noexcept
+    {
+        _ends.pop_back();
+        _bytes.resize(_ends.empty() ? 0 : _ends.back());
+    }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+
+    bool operator==(const BasicStringList& other) const noexcept { return _ends == other._ends && _bytes == other._bytes; }
+    bool operator!=(const BasicStringList& other) const noexcept { return !(*this == other); }
+
+private:
+    std::vector<char, Alloc> _bytes;
+    // End of element i in _bytes, it starts where element i - 1 ends
+    std::vector<uint32_t, OffsetAlloc> _ends;
+};
+
+using StringList = BasicStringList<>;
+
+// Vector keeping its first N elements inline. Repeated fields that usually hold a few items then parse
+// without touching the heap, past N elements it grows into a heap buffer like std::vector.
+template<typename T, size_t N, typename Alloc = std::allocator<T>>
+class SmallVector
+{
+    static_assert(N > 0, "SmallVector needs an inline capacity of at least one element");
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = size_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t InlineCapacity = N;
+
+    SmallVector() noexcept(noexcept(Alloc())) : _storage(Alloc(), InlineData()) {}
+    explicit SmallVector(const Alloc& alloc) noexcept : _storage(alloc, InlineData()) {}
+
+    SmallVector(std::initializer_list<T> values) : SmallVector()
+    {
+        reserve(values.size());
+        for (const T& value : values)
+            push_back(value);
+    }
+
+    SmallVector(const SmallVector& other)
+        : _storage(AllocTraits::select_on_container_copy_construction(other.get_allocator()), InlineData())
+    {
+        CopyFrom(other);
+    }
+
+    SmallVector(const SmallVector& other, const Alloc& alloc) : _storage(alloc, InlineData()) { CopyFrom(other); }
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : _storage(other.get_allocator(), InlineData()) { MoveFrom(other); }
+    SmallVector(SmallVector&& other, const Alloc& alloc) : _storage(alloc, InlineData()) { MoveFrom(other); }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        ReleaseHeap();
+    }
+
+    size_t size() const noexcept { return _storage.size; }
+    size_t capacity() const noexcept { return _storage.capacity; }
+    bool empty() const noexcept { return _storage.size == 0; }
+    // True while the elements still fit the inline buffer
+    bool IsInline() const noexcept { return _storage.data == InlineData(); }
+    allocator_type get_allocator() const noexcept { return _storage; }
+
+    T* data() noexcept { return _storage.data; }
+    const T* data() const noexcept { return _storage.data; }
+    iterator begin() noexcept { return _storage.data; }
+    iterator end() noexcept { return _storage.data + _storage.size; }
+    const_iterator begin() const noexcept { return _storage.data; }
+    const_iterator end() const noexcept { return _storage.data + _storage.size; }
+
+    T& operator[](size_t index) noexcept { return _storage.data[index]; }
+    const T& operator[](size_t index) const noexcept { return _storage.data[index]; }
+    T& front() noexcept { return _storage.data[0]; }
+    const T& front() const noexcept { return _storage.data[0]; }
+    T& back() noexcept { return _storage.data[_storage.size - 1]; }
+    const T& back() const noexcept { return _storage.data[_storage.size - 1]; }
+
+    void reserve(size_t count)
+    {
+        if (count > _storage.capacity)
+            Reallocate(count);
+    }
+
+    // Unlike std::vector, args must not refer to an element of a full vector, push_back copies it first
+    template<typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (_storage.size == _storage.capacity)
+            Reallocate(_storage.capacity * 2);
+
+        Alloc& alloc = _storage;
+        T* item = _storage.data + _storage.size;
+        AllocTraits::construct(alloc, item, std::forward<Args>(args)...);
+        ++_storage.size;
+        return *item;
+    }
+
+    void push_back(const T& value)
+    {
+        // value may be one of our elements, copy it before growing moves it
+        if (_storage.size == _storage.capacity)
+        {
+            T copy(value);
+            emplace_back(std::move(copy));
+        }
+        else
+        {
+            emplace_back(value);
+        }
+    }
+
+    void push_back(T&& value)
+    {
+        if (_storage.size == _storage.capacity)
+        {
+            T moved(std::move(value));
+            emplace_back(std::move(moved));
+        }
+        else
+        {
+            emplace_back(std::move(value));
+        }
+    }
+
+    void pop_back() noexcept
+    {
+        Alloc& alloc = _storage;
+        AllocTraits::destroy(alloc, _storage.data + --_storage.size);
+    }
+
+    // Keeps the capacity, a heap buffer stays allocated
+    void clear() noexcept
+    {
+        while (_storage.size > 0)
+            pop_back();
+    }
+
+    bool operator==(const SmallVector& other) const { return std::equal(begin(), end(), other.begin(), other.end()); }
+    bool operator!=(const SmallVector& other) const { return !(*this == other); }
+
+private:
+    T* InlineData() noexcept { return reinterpret_cast<T*>(_inline); }
+    const T* InlineData() const noexcept { return reinterpret_cast<const T*>(_inline); }
+
+    void Reallocate(size_t newCapacity)
+    {
+        Alloc& alloc = _storage;
+        T* buffer = AllocTraits::allocate(alloc, newCapacity);
+        size_t moved = 0;
+        try
+        {
+            for (; moved < _storage.size; ++moved)
+                AllocTraits::construct(alloc, buffer + moved, std::move_if_noexcept(_storage.data[moved]));
+        }
+        catch (...)
+        {
+            while (moved > 0)
+                AllocTraits::destroy(alloc, buffer + --moved);
+            AllocTraits::deallocate(alloc, buffer, newCapacity);
+            throw;
+        }
+
+        for (size_t i = 0; i < _storage.size; ++i)
+            AllocTraits::destroy(alloc, _storage.data + i);
+        ReleaseHeap();
+
+        _storage.data = buffer;
+        _storage.capacity = newCapacity;
+    }
+
+    void ReleaseHeap() noexcept
+    {
+        if (IsInline())
+            return;
+
+        Alloc& alloc = _storage;
+        AllocTraits::deallocate(alloc, _storage.data, _storage.capacity);
+        _storage.data = InlineData();
+        _storage.capacity = N;
+    }
+
+    void CopyFrom(const SmallVector& other)
+    {
+        reserve(other.size());
+        for (const T& item : other)
+            emplace_back(item);
+    }
+
+    // Takes the heap buffer of other when the allocators allow it, else moves the elements one by one
+    void MoveFrom(SmallVector& other)
+    {
+        if (!other.IsInline() && get_allocator() == other.get_allocator())
+        {
+            ReleaseHeap();
+            _storage.data = std::exchange(other._storage.data, other.InlineData());
+            _storage.size = std::exchange(other._storage.size, 0);
+            _storage.capacity = std::exchange(other._storage.capacity, N);
+            return;
+        }
+
+        reserve(other.size());
+        for (T& item : other)
+            emplace_back(std::move(item));
+        other.clear();
+    }
+
+    // Derives from the allocator so an empty one takes no space
+    struct Storage : Alloc
+    {
+        Storage(const Alloc& alloc, T* inlineData) noexcept : Alloc(alloc), data(inlineData) {}
+
+        T* data;
+        size_t size = 0;
+        size_t capacity = N;
+    };
+
+    Storage _storage;
+    alignas(T) unsigned char _inline[sizeof(T) * N];
+};
+
+// Map stored as a vector of pairs sorted by key: one allocation for all entries and binary search lookups.
+// The parser appends entries unsorted and calls Finalize once the message is parsed, so building it is
+// O(n log n) instead of one sorted insertion per entry. Later duplicates win, like protobuf maps.
+template<typename K, typename V, typename Compare = std::less<K>, typename Alloc = std::allocator<std::pair<K, V>>>
+class FlatMap
+{
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using allocator_type = Alloc;
+    using container_type = std::vector<value_type, Alloc>;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    FlatMap() = default;
+    explicit FlatMap(const Alloc& alloc) : _entries(alloc) {}
+    FlatMap(std::initializer_list<value_type> values) : _entries(values), _sorted(false) { Finalize(); }
+    FlatMap(const FlatMap& other, const Alloc& alloc) : _entries(other._entries, alloc), _sorted(other._sorted) {}
+    FlatMap(FlatMap&& other, const Alloc& alloc) : _entries(std::move(other._entries), alloc), _sorted(other._sorted) {}
+    FlatMap(const FlatMap&) = default;
+    FlatMap(FlatMap&&) = default;
+    FlatMap& operator=(const FlatMap&) = default;
+    FlatMap& operator=(FlatMap&&) = default;
+
+    size_t size() const noexcept { return _entries.size(); }
+    bool empty() const noexcept { return _entries.empty(); }
+    void reserve(size_t count) { _entries.reserve(count); }
+    void clear() noexcept { _entries.clear(); _sorted = true; }
+    // Heap bytes held by the entry array, not by the keys and values themselves
+    size_t CapacityBytes() const noexcept { return _entries.capacity() * sizeof(value_type); }
+    allocator_type get_allocator() const noexcept { return _entries.get_allocator(); }
+
+    iterator begin() noexcept { return _entries.begin(); }
+    iterator end() noexcept { return _entries.end(); }
+    const_iterator begin() const noexcept { return _entries.begin(); }
+    const_iterator end() const noexcept { return _entries.end(); }
+
+    iterator find(const K& key)
+    {
+        assert(_sorted && "FlatMap used before Finalize");
+        auto it = LowerBound(key);
+        return it != _entries.end() && !_compare(key, it->first) ? it : _entries.end();
+    }
+
+    const_iterator find(const K& key) const
+    {
+        return const_cast<FlatMap*>(this)->find(key);
+    }
+
+    size_t count(const K& key) const { return find(key) != end() ? 1 : 0; }
+    bool contains(const K& key) const { return find(key) != end(); }
+
+    V& at(const K& key)
+    {
+        auto it = find(key);
+        if (it == _entries.end())
+            throw std::out_of_range("FlatMap::at key not found");
+
+        return it->second;
+    }
+
+    const V& at(const K& key) const { return const_cast<FlatMap*>(this)->at(key); }
+
+    V& operator[](const K& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        assert(_sorted && "FlatMap used before Finalize");
+        auto it = LowerBound(key);
+        if (it != _entries.end() && !_compare(key, it->first))
+            return { it, false };
+
+        it = _entries.emplace(it, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        return { it, true };
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value)
+    {
+        auto result = try_emplace(key, std::forward<M>(value));
+        if (!result.second)
+            result.first->second = std::forward<M>(value);
+
+        return result;
+    }
+
+    size_t erase(const K& key)
+    {
+        auto it = find(key);
+        if (it == _entries.end())
+            return 0;
+
+        _entries.erase(it);
+        return 1;
+    }
+
+    // Bulk building: append in any order, then Finalize before any lookup.
+    void AppendUnsorted(K&& key, V&& value)
+    {
+        _entries.emplace_back(std::move(key), std::move(value));
+        _sorted = false;
+    }
+
+    void Finalize()
+    {
+        if (_sorted)
+            return;
+
+        // Stable, so the last of equal keys is the last one appended
+        std::stable_sort(_entries.begin(), _entries.end(), [this](const value_type& a, const value_type& b) { return _compare(a.first, b.first); });
+
+        auto out = _entries.begin();
+        for (auto it = _entries.begin(); it != _entries.end(); ++it)
+        {
+            auto next = std::next(it);
+            if (next != _entries.end() && !_compare(it->first, next->first))
+                continue;
+
+            if (out != it)
+                *out = std::move(*it);
+            ++out;
+        }
+        _entries.erase(out, _entries.end());
+        _sorted = true;
+    }
+
+    bool operator==(const FlatMap& other) const { return _entries == other._entries; }
+    bool operator!=(const FlatMap& other) const { return !(*this == other); }
+
+private:
+    iterator LowerBound(const K& key)
+    {
+        return std::lower_bound(_entries.begin(), _entries.end(), key, [this](const value_type& entry, const K& k) { return _compare(entry.first, k); });
+    }
+
+    container_type _entries;
+    Compare _compare{};
+    bool _sorted = true;
+};
+
+// Lazily allocated storage of the cold fields of a message (fields marked [(protobuflight.cold) = true]
+// or listed with --cold-fields). Nothing is allocated until a cold field is written or parsed.
+template<typename T, typename Alloc = std::allocator<T>>
+class ColdFields
+{
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    ColdFields() = default;
+    explicit ColdFields(const Alloc& alloc) noexcept : _storage(alloc) {}
+
+    ColdFields(const ColdFields& other) :
+        ColdFields(other, AllocTraits::select_on_container_copy_construction(other.get_allocator()))
+    {}
+
+    ColdFields(const ColdFields& other, const Alloc& alloc) : _storage(alloc)
+    {
+        if (other.HasValue())
+            Create(*other._storage.value);
+    }
+
+    ColdFields(ColdFields&& other) noexcept : _storage(other.get_allocator())
+    {
+        _storage.value = std::exchange(other._storage.value, nullptr);
+    }
+
+    ColdFields(ColdFields&& other, const Alloc& alloc) : _storage(alloc)
+    {
+        if (get_allocator() == other.get_allocator())
+            _storage.value = std::exchange(other._storage.value, nullptr);
+        else if (other.HasValue())
+            Create(std::move(*other._storage.value));
+    }
+
+    // Like std::pmr containers the allocator never propagates on assignment
+    ColdFields& operator=(const ColdFields& other)
+    {
+        if (this == &other)
+            return *this;
+
+        if (!other.HasValue())
+            Reset();
+        else if (HasValue())
+            *_storage.value = *other._storage.value;
+        else
+            Create(*other._storage.value);
+
+        return *this;
+    }
+
+    ColdFields& operator=(ColdFields&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        if (get_allocator() == other.get_allocator())
+        {
+            Reset();
+            _storage.value = std::exchange(other._storage.value, nullptr);
+        }
+        else if (!other.HasValue())
+            Reset();
+        else if (HasValue())
+            *_storage.value = std::move(*other._storage.value);
+        else
+            Create(std::move(*other._storage.value));
+
+        return *this;
+    }
+
+    ~ColdFields() { Reset(); }
+
+    bool HasValue() const noexcept { return _storage.value != nullptr; }
+
+    // Default values when nothing was allocated yet
+    const T& Get() const
+    {
+        if (HasValue())
+            return *_storage.value;
+
+        static const T empty{};
+        return empty;
+    }
+
+    T& Mutable()
+    {
+        if (!HasValue())
+            Create();
+
+        return *_storage.value;
+    }
+
+    void Reset() noexcept
+    {
+        if (!HasValue())
+            return;
+
+        Alloc& alloc = _storage;
+        AllocTraits::destroy(alloc, _storage.value);
+        AllocTraits::deallocate(alloc, _storage.value, 1);
+        _storage.value = nullptr;
+    }
+
+    allocator_type get_allocator() const noexcept { return _storage; }
+
+private:
+    template<typename... Args>
+    void Create(Args&&... args)
+    {
+        Alloc& alloc = _storage;
+        T* value = AllocTraits::allocate(alloc, 1);
+        try
+        {
+            // polymorphic_allocator passes itself to allocator-aware cold structs
+            AllocTraits::construct(alloc, value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            AllocTraits::deallocate(alloc, value, 1);
+            throw;
+        }
+        _storage.value = value;
+    }
+
+    // Derives from the allocator so an empty one takes no space
+    struct Storage : Alloc
+    {
+        Storage() = default;
+        explicit Storage(const Alloc& alloc) noexcept : Alloc(alloc) {}
+
+        T* value = nullptr;
+    };
+
+    Storage _storage;
+};
+
+// Fixed size node allocator shared by every NodePoolAllocator<T>. Nodes are carved from chunks that are
+// never returned to the system, freed nodes are reused by later allocations. Each thread caches up to
+// 2 * BatchSize free nodes and exchanges them with the shared free list in batches, so most allocations
+// and frees of a deep tree don't take the lock.
+template<typename T>
+class NodePool
+{
+public:
+    static constexpr size_t BatchSize = 32;
+
+    // Leaked on purpose, nodes of static messages may be freed after static destructors ran
+    static NodePool& Instance()
+    {
+        static NodePool* pool = new NodePool();
+        return *pool;
+    }
+
+    void* Allocate()
+    {
+        Cache* cache = LocalCache();
+        if (cache == nullptr)
+        {
+            // During thread exit, after the thread cache is gone, a batch is borrowed for this node only
+            Cache batch;
+            return Take(batch);
+        }
+
+        return Take(*cache);
+    }
+
+    void Deallocate(void* node) noexcept
+    {
+        Slot* slot = static_cast<Slot*>(node);
+        Cache* cache = LocalCache();
+        if (cache == nullptr)
+        {
+            // Nodes freed by thread_local messages destroyed after the thread cache go straight to the shared list
+            std::lock_guard<std::mutex> lock(_mutex);
+            slot->next = _free;
+            _free = slot;
+            return;
+        }
+
+        slot->next = cache->head;
+        cache->head = slot;
+        if (++cache->count > 2 * BatchSize)
+            Release(*cache, BatchSize);
+    }
+
+    // Nodes allocated from the system so far, in use or free
+    size_t Capacity() const
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _capacity;
+    }
+
+private:
+    union Slot
+    {
+        Slot* next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct Cache
+    {
+        Slot* head = nullptr;
+        size_t count = 0;
+
+        ~Cache() { NodePool::Instance().Release(*this, count); }
+    };
+
+    struct ThreadCache : Cache
+    {
+        ~ThreadCache() { ThreadCacheDestroyed() = true; }
+    };
+
+    NodePool() = default;
+
+    // Trivially destructible, so it stays readable after the thread cache itself is gone
+    static bool& ThreadCacheDestroyed() noexcept
+    {
+        static thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    static Cache* LocalCache() noexcept
+    {
+        if (ThreadCacheDestroyed())
+            return nullptr;
+
+        static thread_local ThreadCache cache;
+        return &cache;
+    }
+
+    Slot* Take(Cache& cache)
+    {
+        if (cache.head == nullptr)
+            Refill(cache);
+
+        Slot* slot = cache.head;
+        cache.head = slot->next;
+        --cache.count;
+        return slot;
+    }
+
+    void Refill(Cache& cache)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_free == nullptr)
+        {
+            // Chunks double up to 4096 nodes, small trees don't reserve much
+            const size_t count = std::min<size_t>(std::max<size_t>(_capacity, BatchSize), 4096);
+            auto chunk = std::make_unique<Slot[]>(count);
+            for (size_t i = 0; i < count; ++i)
+                chunk[i].next = i + 1 < count ? &chunk[i + 1] : nullptr;
+
+            _free = &chunk[0];
+            _capacity += count;
+            _chunks.push_back(std::move(chunk));
+        }
+
+        while (_free != nullptr && cache.count < BatchSize)
+        {
+            Slot* slot = _free;
+            _free = slot->next;
+            slot->next = cache.head;
+            cache.head = slot;
+            ++cache.count;
+        }
+    }
+
+    void Release(Cache& cache, size_t count) noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (; count > 0 && cache.head != nullptr; --count)
+        {
+            Slot* slot = cache.head;
+            cache.head = slot->next;
+            --cache.count;
+            slot->next = _free;
+            _free = slot;
+        }
+    }
+
+    mutable std::mutex _mutex;
+    Slot* _free = nullptr;
+    size_t _capacity = 0;
+    std::vector<std::unique_ptr<Slot[]>> _chunks;
+};
+
+// Stateless allocator handing out single nodes from NodePool<T>, larger requests use operator new.
+template<typename T>
+class NodePoolAllocator
 {
-    explicit ParseError(const std::string& m) : std::runtime_error(m) {}
-    explicit ParseError(const char* m) : std::runtime_error(m) {}
+public:
+    using value_type = T;
+
+    NodePoolAllocator() noexcept = default;
+    template<typename U>
+    NodePoolAllocator(const NodePoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t count)
+    {
+        if (count == 1)
+            return static_cast<T*>(NodePool<T>::Instance().Allocate());
+
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) noexcept
+    {
+        if (count == 1)
+            NodePool<T>::Instance().Deallocate(pointer);
+        else
+            std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template<typename U>
+    bool operator==(const NodePoolAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const NodePoolAllocator<U>&) const noexcept { return false; }
+};
+
+// Owning pointer to a submessage of a recursive schema, a tree node or one step of mutually recursive
+// messages. Same lazily allocated storage as ColdFields: null until written, Get() returns the default
+// message when null. Nodes come from NodePool<T>, or from the arena with the --pmr allocator.
+template<typename T, typename Alloc = NodePoolAllocator<T>>
+class NodePtr : public ColdFields<T, Alloc>
+{
+public:
+    using ColdFields<T, Alloc>::ColdFields;
+
+    NodePtr() = default;
+    NodePtr(const T& value) { this->Mutable() = value; }
+    NodePtr(T&& value) { this->Mutable() = std::move(value); }
+};
+
+// Heap allocated value with value semantics. Oneof alternatives larger than --box-threshold are boxed,
+// so the variant only grows by a pointer and the value is allocated once the alternative is selected.
+template<typename T, typename Alloc = std::allocator<T>>
+class Box
+{
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+
+    Box() : Box(Alloc()) {}
+    explicit Box(const Alloc& alloc) : _storage(alloc) { Create(); }
+    Box(const T& value) : _storage(Alloc()) { Create(value); }
+    Box(T&& value) : _storage(Alloc()) { Create(std::move(value)); }
+
+    Box(const Box& other) : _storage(AllocTraits::select_on_container_copy_construction(other.get_allocator()))
+    {
+        Create(*other);
+    }
+
+    Box(const Box& other, const Alloc& alloc) : _storage(alloc) { Create(*other); }
+
+    // The moved from box holds a default constructed value, a box is never empty
+    Box(Box&& other) : _storage(other.get_allocator())
+    {
+        Create();
+        std::swap(_storage.value, other._storage.value);
+    }
+
+    Box& operator=(const Box& other)
+    {
+        if (this == &other)
+            return *this;
+
+        *_storage.value = *other;
+        return *this;
+    }
+
+    Box& operator=(Box&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        // Values are swapped, so the moved from box keeps one
+        if (get_allocator() == other.get_allocator())
+            std::swap(_storage.value, other._storage.value);
+        else
+            *_storage.value = std::move(*other);
+
+        return *this;
+    }
+
+    ~Box() { Destroy(); }
+
+    T& operator*() noexcept { return *_storage.value; }
+    const T& operator*() const noexcept { return *_storage.value; }
+    T* operator->() noexcept { return _storage.value; }
+    const T* operator->() const noexcept { return _storage.value; }
+    T* get() noexcept { return _storage.value; }
+    const T* get() const noexcept { return _storage.value; }
+
+    allocator_type get_allocator() const noexcept { return _storage; }
+
+    bool operator==(const Box& other) const { return **this == *other; }
+    bool operator!=(const Box& other) const { return !(*this == other); }
+
+private:
+    template<typename... Args>
+    void Create(Args&&... args)
+    {
+        Alloc& alloc = _storage;
+        T* value = AllocTraits::allocate(alloc, 1);
+        try
+        {
+            AllocTraits::construct(alloc, value, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            AllocTraits::deallocate(alloc, value, 1);
+            throw;
+        }
+        _storage.value = value;
+    }
+
+    void Destroy() noexcept
+    {
+        if (_storage.value == nullptr)
+            return;
+
+        Alloc& alloc = _storage;
+        AllocTraits::destroy(alloc, _storage.value);
+        AllocTraits::deallocate(alloc, _storage.value, 1);
+        _storage.value = nullptr;
+    }
+
+    // Derives from the allocator so an empty one takes no space
+    struct Storage : Alloc
+    {
+        explicit Storage(const Alloc& alloc) noexcept : Alloc(alloc) {}
+
+        T* value = nullptr;
+    };
+
+    Storage _storage;
+};
+
+// Immutable byte slice that shares ownership of its buffer, copying one only bumps a reference count.
+// Parsing from a SharedBytes buffer (see Reflection::ParseStruct) makes SharedBytes fields alias the input.
+class SharedBytes
+{
+public:
+    using value_type = char;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+
+    SharedBytes() = default;
+
+    SharedBytes(std::string bytes)
+    {
+        auto owner = std::make_shared<const std::string>(std::move(bytes));
+        _data = owner->data();
+        _size = owner->size();
+        _owner = std::move(owner);
+    }
+
+    explicit SharedBytes(std::string_view bytes) : SharedBytes(std::string(bytes)) {}
+
+    // Slice of a buffer kept alive by owner, nothing is copied
+    SharedBytes(std::shared_ptr<const void> owner, const char* data, size_t size) noexcept
+        : _owner(std::move(owner)), _data(data), _size(size)
+    {
+    }
+
+    const char* data() const noexcept { return _data; }
+    size_t size() const noexcept { return _size; }
+    bool empty() const noexcept { return _size == 0; }
+    const_iterator begin() const noexcept { return _data; }
+    const_iterator end() const noexcept { return _data + _size; }
+    char operator[](size_t i) const noexcept { return _data[i]; }
+
+    std::string_view View() const noexcept { return std::string_view(_data, _size); }
+    operator std::string_view() const noexcept { return View(); }
+
+    // Shares the buffer, throws std::out_of_range when the slice doesn't fit
+    SharedBytes Slice(size_t offset, size_t length) const
+    {
+        if (offset > _size || length > _size - offset)
+            throw std::out_of_range("SharedBytes slice out of range");
+
+        return SharedBytes(_owner, _data + offset, length);
+    }
+
+    // True when [data, data + size) lies inside this slice, Slice can then take it without a copy
+    bool Contains(const char* data, size_t size) const noexcept
+    {
+        const std::less_equal<const char*> lessEqual;
+        return size == 0 || (_data != nullptr && lessEqual(_data, data) && lessEqual(data + size, _data + _size));
+    }
+
+    long UseCount() const noexcept { return _owner.use_count(); }
+
+    bool operator==(const SharedBytes& other) const noexcept { return View() == other.View(); }
+    bool operator!=(const SharedBytes& other) const noexcept { return !(*this == other); }
+
+private:
+    std::shared_ptr<const void> _owner;
+    const char* _data = nullptr;
+    size_t _size = 0;
+};
+
+// Process wide set of unique strings. Entries are never removed, so it is meant for fields holding
+// a bounded set of values (region, host or metric names).
+// The table is split in shards by hash, each with its own lock, and hits only take a shared lock.
+class InternTable
+{
+public:
+    static constexpr size_t ShardCount = 16;
+
+    static InternTable& Global()
+    {
+        static InternTable table;
+        return table;
+    }
+
+    // The returned string stays valid and at the same address for the lifetime of the table
+    const std::string* Intern(std::string_view value)
+    {
+        const size_t hash = std::hash<std::string_view>()(value);
+        Shard& shard = _shards[hash % ShardCount];
+
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.entries.find(value);
+            if (it != shard.entries.end())
+                return it->second;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.entries.find(value);
+        if (it != shard.entries.end())
+            return it->second;
+
+        // std::deque doesn't move its elements when growing, the keys can view the stored strings
+        const std::string& stored = shard.storage.emplace_back(value);
+        shard.entries.emplace(std::string_view(stored), &stored);
+        return &stored;
+    }
+
+    size_t size() const
+    {
+        size_t count = 0;
+        for (const Shard& shard : _shards)
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            count += shard.entries.size();
+        }
+        return count;
+    }
+
+private:
+    struct Shard
+    {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string_view, const std::string*> entries;
+        std::deque<std::string> storage;
+    };
+
+    std::array<Shard, ShardCount> _shards;
+};
+
+// Handle to a string of InternTable::Global(): 8 bytes per field, equal strings share one copy
+// and compare equal by pointer. The empty string is a null handle and is never interned.
+class InternedString
+{
+public:
+    using value_type = char;
+    using const_iterator = const char*;
+    using iterator = const_iterator;
+
+    InternedString() = default;
+    InternedString(std::string_view value) : _value(value.empty() ? nullptr : InternTable::Global().Intern(value)) {}
+    InternedString(const std::string& value) : InternedString(std::string_view(value)) {}
+    InternedString(const char* value) : InternedString(std::string_view(value)) {}
+
+    const char* data() const noexcept { return _value != nullptr ? _value->data() : ""; }
+    size_t size() const noexcept { return _value != nullptr ? _value->size() : 0; }
+    bool empty() const noexcept { return _value == nullptr; }
+    const_iterator begin() const noexcept { return data(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+    std::string_view View() const noexcept { return std::string_view(data(), size()); }
+    operator std::string_view() const noexcept { return View(); }
+
+    bool operator==(const InternedString& other) const noexcept { return _value == other._value; }
+    bool operator!=(const InternedString& other) const noexcept { return _value != other._value; }
+    // Ordered by content so std::map keys iterate like std::string keys
+    bool operator<(const InternedString& other) const noexcept { return View() < other.View(); }
+
+    // Identity of the string in the table, equal strings have equal ids
+    const void* Id() const noexcept { return _value; }
+
+private:
+    const std::string* _value = nullptr;
+};
+
+// What ForEachField hands out for a cold field: reads go through ColdFields::Get, writes allocate the cold struct.
+template<typename HolderT, typename ValueT>
+class ColdRef
+{
+public:
+    using value_type = ValueT;
+    using ColdT = typename HolderT::value_type;
+
+    ColdRef(HolderT& holder, ValueT ColdT::* member) noexcept : _holder(holder), _member(member) {}
+
+    bool HasValue() const noexcept { return _holder.HasValue(); }
+    const ValueT& Value() const { return _holder.Get().*_member; }
+    ValueT& Mutable() const { return _holder.Mutable().*_member; }
+
+    void Clear() const
+    {
+        if (_holder.HasValue())
+            _holder.Mutable().*_member = ValueT{};
+    }
+
+private:
+    HolderT& _holder;
+    ValueT ColdT::* _member;
 };
 
+template<typename HolderT, typename ColdT, typename ValueT>
+ColdRef<HolderT, ValueT> MakeColdRef(HolderT& holder, ValueT ColdT::* member) noexcept
+{
+    static_assert(std::is_same_v<ColdT, typename HolderT::value_type>, "Cold member doesn't belong to this ColdFields");
+    return ColdRef<HolderT, ValueT>(holder, member);
+}
+
 namespace Detail {
-    template<typename, typename = void>
-    struct has_data_and_size : std::false_type {};
 
     template<typename T>
-    struct has_data_and_size<T, std::void_t<
-        decltype(std::declval<const T&>().data()),
-        decltype(std::declval<const T&>().size())
-    >> : std::true_type {};
+    struct is_has_bit_ref : std::false_type {};
+
+    template<typename ValueT, typename BitsT>
+    struct is_has_bit_ref<HasBitRef<ValueT, BitsT>> : std::true_type {};
 
     template<typename T>
-    constexpr bool has_data_and_size_v = has_data_and_size<T>::value;
+    constexpr bool is_has_bit_ref_v = is_has_bit_ref<T>::value;
 
-    template<typename T, typename... Ts>
-    constexpr bool is_any_v = (std::is_same_v<T, Ts> || ...);
+    template<typename T>
+    struct is_bool_ref : std::false_type {};
+
+    template<typename BitsT>
+    struct is_bool_ref<BoolRef<BitsT>> : std::true_type {};
 
     template<typename T>
-    constexpr bool is_byte_like_v = is_any_v<T, std::byte, uint8_t, unsigned char, int8_t, signed char, char>;
+    constexpr bool is_bool_ref_v = is_bool_ref<T>::value;
 
     template<typename T>
-    struct is_variant : std::false_type {};
+    struct is_bool_vector : std::false_type {};
 
-    template<typename... Ts>
-    struct is_variant<std::variant<Ts...>> : std::true_type {};
+    template<typename Alloc>
+    struct is_bool_vector<BasicBoolVector<Alloc>> : std::true_type {};
 
     template<typename T>
-    constexpr bool is_variant_v = is_variant<T>::value;
+    constexpr bool is_bool_vector_v = is_bool_vector<T>::value;
 
-    template<typename C, typename = void>
-    struct is_byte_container : std::false_type {};
+    template<typename T>
+    struct is_string_list : std::false_type {};
 
-    template<typename C>
-    struct is_byte_container<C, std::enable_if_t<has_data_and_size_v<C>>> {
-    private:
-        using PtrT = decltype(std::declval<const C&>().data());
-        using ElemT = std::remove_cv_t<std::remove_pointer_t<PtrT>>;
-    public:
-        static constexpr bool value = is_byte_like_v<ElemT>;
-    };
+    template<typename Alloc>
+    struct is_string_list<BasicStringList<Alloc>> : std::true_type {};
 
-    template<typename C>
-    constexpr bool is_byte_container_v = is_byte_container<C>::value;
+    template<typename T>
+    constexpr bool is_string_list_v = is_string_list<T>::value;
 
-    template<typename, typename = void>
-    struct has_push_back_method : std::false_type {};
+    template<typename T>
+    struct is_small_vector : std::false_type {};
 
-    template<typename C>
-    struct has_push_back_method<C, std::void_t<
-        decltype(std::declval<C&>().push_back(std::declval<typename C::value_type>()))
-    >> : std::true_type {};
+    template<typename T, size_t N, typename Alloc>
+    struct is_small_vector<SmallVector<T, N, Alloc>> : std::true_type {};
 
-    template<typename C>
-    constexpr bool has_push_back_method_v = has_push_back_method<C>::value;
+    template<typename T>
+    constexpr bool is_small_vector_v = is_small_vector<T>::value;
 
-    template<typename C>
-    constexpr bool is_appendable_byte_container_v = is_byte_container_v<C> && has_push_back_method_v<C>;
+    // Containers reflection encodes as a repeated field, item by item or packed
+    template<typename T>
+    constexpr bool is_repeated_v = is_std_vector_v<T> || is_small_vector_v<T>;
 
     template<typename T>
-    struct is_std_map : std::false_type {};
+    struct is_flat_map : std::false_type {};
 
-    template<typename K, typename V, typename Pr, typename Alloc>
-    struct is_std_map<std::map<K, V, Pr, Alloc>> : std::true_type {};
+    template<typename K, typename V, typename Compare, typename Alloc>
+    struct is_flat_map<FlatMap<K, V, Compare, Alloc>> : std::true_type {};
 
     template<typename T>
-    constexpr bool is_std_map_v = is_std_map<T>::value;
+    constexpr bool is_flat_map_v = is_flat_map<T>::value;
 
+    // Every map representation reflection can encode, they all share the protobuf map wire format
     template<typename T>
-    struct is_std_vector : std::false_type {};
+    constexpr bool is_map_v = is_std_map_v<T> || is_std_unordered_map_v<T> || is_flat_map_v<T>;
 
     template<typename T>
-    struct is_std_vector<std::vector<T>> : std::true_type {};
+    struct is_box : std::false_type {};
+
+    template<typename T, typename Alloc>
+    struct is_box<Box<T, Alloc>> : std::true_type {};
 
     template<typename T>
-    constexpr bool is_std_vector_v = is_std_vector<T>::value;
+    constexpr bool is_box_v = is_box<T>::value;
 
     template<typename T>
-    struct is_std_optional : std::false_type {};
+    constexpr bool is_shared_bytes_v = std::is_same_v<T, SharedBytes>;
 
     template<typename T>
-    struct is_std_optional<std::optional<T>> : std::true_type {};
+    constexpr bool is_interned_string_v = std::is_same_v<T, InternedString>;
 
     template<typename T>
-    constexpr bool is_std_optional_v = is_std_optional<T>::value;
+    struct is_node_ptr : std::false_type {};
 
-    template<typename MemberT, typename MetaT>
-    constexpr void ValidateFieldmetaVariant() {
-        static_assert(is_variant_v<MemberT>, "Called validate_fieldmeta_variant on non-variant");
+    template<typename T, typename Alloc>
+    struct is_node_ptr<NodePtr<T, Alloc>> : std::true_type {};
 
-        using FirstAlt = std::variant_alternative_t<0, MemberT>;
-        static_assert(std::is_same_v<FirstAlt, std::monostate>,
-            "Oneof variant must have std::monostate as first alternative");
+    template<typename T>
+    constexpr bool is_node_ptr_v = is_node_ptr<T>::value;
 
-        constexpr size_t variant_size = std::variant_size_v<MemberT>;
-        constexpr size_t expected_numbers = variant_size - 1;
+    template<typename T>
+    struct is_cold_ref : std::false_type {};
 
-        constexpr auto& nums = MetaT::numbers;
-        static_assert(nums.size() == expected_numbers,
-            "FieldMeta numbers must have exactly variant_size-1 entries for oneof (excluding monostate)");
-    }
+    template<typename HolderT, typename ValueT>
+    struct is_cold_ref<ColdRef<HolderT, ValueT>> : std::true_type {};
+
+    template<typename T>
+    constexpr bool is_cold_ref_v = is_cold_ref<T>::value;
 
 } // namespace Detail
 
@@ -213,7 +1867,7 @@ inline constexpr uint64_t MakeTag(int fieldNumber, WireType wire_type)
     return (static_cast<uint64_t>(fieldNumber) << 3) | static_cast<uint64_t>(wire_type);
 }
 
-inline size_t VarintEncodedSize(uint64_t value)
+inline constexpr size_t VarintEncodedSize(uint64_t value)
 {
     size_t size = 0;
     while (value >= 0x80)
@@ -225,8 +1879,14 @@ inline size_t VarintEncodedSize(uint64_t value)
     return size;
 }
 
+inline constexpr size_t KeyEncodedSize(uint32_t fieldNumber)
+{
+    // The wire type lives in the 3 low bits, it never changes the varint length.
+    return VarintEncodedSize(MakeTag(fieldNumber, WireType::VARINT));
+}
+
 template<typename Container, typename = std::enable_if_t<Detail::is_appendable_byte_container_v<Container>>>
-void EncodeVarint(uint64_t value, Container& out)
+constexpr void EncodeVarint(uint64_t value, Container& out)
 {
     while (value >= 0x80)
     {
@@ -236,7 +1896,7 @@ void EncodeVarint(uint64_t value, Container& out)
     out.push_back(static_cast<typename Container::value_type>(value));
 }
 
-inline bool DecodeVarint(const uint8_t* buf, size_t size, size_t& idx, uint64_t& value)
+inline constexpr bool DecodeVarint(const uint8_t* buf, size_t size, size_t& idx, uint64_t& value)
 {
     uint64_t result = 0;
     int shift = 0;
@@ -257,14 +1917,14 @@ inline bool DecodeVarint(const uint8_t* buf, size_t size, size_t& idx, uint64_t&
 }
 
 template<typename Container>
-std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> WriteKey(uint32_t fieldNumber, uint8_t wireType, Container& out)
+constexpr std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> WriteKey(uint32_t fieldNumber, uint8_t wireType, Container& out)
 {
     EncodeVarint((fieldNumber << 3) | wireType, out);
 }
 
-inline bool ReadKey(const uint8_t* buf, size_t size, size_t& idx, uint32_t& fieldNumber, uint8_t& wireType)
+inline constexpr bool ReadKey(const uint8_t* buf, size_t size, size_t& idx, uint32_t& fieldNumber, uint8_t& wireType)
 {
-    uint64_t key;
+    uint64_t key = 0;
     if (!DecodeVarint(buf, size, idx, key))
         return false;
 
@@ -274,7 +1934,7 @@ inline bool ReadKey(const uint8_t* buf, size_t size, size_t& idx, uint32_t& fiel
 }
 
 template<typename T, typename Container>
-std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> Write(T&& value, Container& out)
+constexpr std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> Write(T&& value, Container& out)
 {
     using DecayT = std::decay_t<T>;
     if constexpr (Detail::is_any_v<DecayT, int32_t, int64_t, uint32_t, uint64_t, size_t>)
@@ -292,7 +1952,11 @@ std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> Write(T&& va
     }
     else if constexpr (Detail::is_any_v<DecayT, float, double>)
     {
-        out.insert(out.end(), reinterpret_cast<const typename Container::value_type*>(&value), reinterpret_cast<const typename Container::value_type*>(&value) + sizeof(DecayT));
+        // Fixed width values are little endian on the wire
+        using BitsT = std::conditional_t<sizeof(DecayT) == 4, uint32_t, uint64_t>;
+        const BitsT bits = Detail::BitCast<BitsT>(value);
+        for (size_t i = 0; i < sizeof(BitsT); ++i)
+            out.push_back(static_cast<typename Container::value_type>((bits >> (i * 8)) & 0xFF));
     }
     else if constexpr (Detail::is_byte_container_v<DecayT>)
     {
@@ -306,7 +1970,7 @@ std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> Write(T&& va
 }
 
 template<typename T>
-size_t SerializedSize(T&& value)
+constexpr size_t SerializedSize(T&& value)
 {
     using DecayT = std::decay_t<T>;
     if constexpr (Detail::is_any_v<DecayT, int32_t, int64_t, uint32_t, uint64_t, size_t>)
@@ -336,12 +2000,28 @@ size_t SerializedSize(T&& value)
     }
 }
 
-inline bool SkipField(uint8_t wireType, const uint8_t* buf, size_t size, size_t& idx)
+// Reads a length delimited payload without copying it, data points inside buf.
+inline constexpr bool ReadLengthDelimited(const uint8_t* buf, size_t size, size_t& idx, const uint8_t*& data, size_t& length)
+{
+    uint64_t tmp = 0;
+    if (!DecodeVarint(buf, size, idx, tmp))
+        return false;
+
+    if (tmp > size - idx)
+        return false;
+
+    data = buf + idx;
+    length = static_cast<size_t>(tmp);
+    idx += length;
+    return true;
+}
+
+inline constexpr bool SkipField(uint8_t wireType, const uint8_t* buf, size_t size, size_t& idx)
 {
     switch (wireType) {
         case WireType::VARINT:
         {
-            uint64_t tmp;
+            uint64_t tmp = 0;
             if (!DecodeVarint(buf, size, idx, tmp))
                 return false;
             break;
@@ -353,7 +2033,7 @@ inline bool SkipField(uint8_t wireType, const uint8_t* buf, size_t size, size_t&
             idx += 8;
             break;
         case WireType::LENGTH_DELIMITED: {
-            uint64_t len;
+            uint64_t len = 0;
             if (!DecodeVarint(buf, size, idx, len))
                 return false;
 
@@ -377,7 +2057,7 @@ inline bool SkipField(uint8_t wireType, const uint8_t* buf, size_t size, size_t&
 }
 
 template<typename T>
-bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
+constexpr bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
 {
     using DecayT = std::decay_t<T>;
     if (idx >= size)
@@ -385,7 +2065,7 @@ bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
 
     if constexpr (Detail::is_any_v<DecayT, int32_t, int64_t, uint32_t, uint64_t, size_t>)
     {
-        uint64_t tmp;
+        uint64_t tmp = 0;
         if (!DecodeVarint(buf, size, idx, tmp))
             return false;
 
@@ -393,7 +2073,7 @@ bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
     }
     else if constexpr (std::is_same_v<DecayT, bool>)
     {
-        uint64_t tmp;
+        uint64_t tmp = 0;
         if (!DecodeVarint(buf, size, idx, tmp))
             return false;
         
@@ -402,23 +2082,30 @@ bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
     else if constexpr (std::is_enum_v<DecayT>)
     {
         using U = std::underlying_type_t<DecayT>;
-        uint64_t tmp;
+        uint64_t tmp = 0;
         if (!DecodeVarint(buf, size, idx, tmp))
             return false;
 
-        value = static_cast<DecayT>(static_cast<U>(tmp));
+        // Unknown values that don't fit a narrowed enum are dropped, like closed enums do
+        if (Detail::EnumValueFits<DecayT>(tmp))
+            value = static_cast<DecayT>(static_cast<U>(tmp));
     }
     else if constexpr (Detail::is_any_v<DecayT, float, double>)
     {
         if ((idx + sizeof(DecayT)) > size)
             return false;
 
-        std::memcpy(reinterpret_cast<void*>(&value), reinterpret_cast<const void*>(buf + idx), sizeof(DecayT));
+        using BitsT = std::conditional_t<sizeof(DecayT) == 4, uint32_t, uint64_t>;
+        BitsT bits = 0;
+        for (size_t i = 0; i < sizeof(BitsT); ++i)
+            bits |= static_cast<BitsT>(buf[idx + i]) << (i * 8);
+
+        value = Detail::BitCast<DecayT>(bits);
         idx += sizeof(DecayT);
     }
     else if constexpr (std::is_same_v<DecayT, std::string_view>)
     {
-        uint64_t length;
+        uint64_t length = 0;
         if (!DecodeVarint(buf, size, idx, length))
             return false;
 
@@ -431,14 +2118,15 @@ bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
     }
     else if constexpr (Detail::is_std_optional_v<DecayT>)
     {
-        typename DecayT::value_type optionalValue;
+        typename DecayT::value_type optionalValue{};
         if (!Read(buf, size, idx, optionalValue))
             return false;
-        value.emplace(std::move(optionalValue));
+        // Not emplace(), it is only constexpr since C++20
+        value = DecayT{ std::in_place, std::move(optionalValue) };
     }
     else if constexpr (Detail::is_appendable_byte_container_v<DecayT>)
     {
-        uint64_t length;
+        uint64_t length = 0;
         if (!DecodeVarint(buf, size, idx, length))
             return false;
 
@@ -461,3 +2149,13 @@ bool Read(const uint8_t* buf, size_t size, size_t& idx, T& value)
 }
 
 } // namespace ProtobufLight
+
+template<>
+struct std::hash<ProtobufLight::InternedString>
+{
+    size_t operator()(const ProtobufLight::InternedString& value) const noexcept
+    {
+        return std::hash<const void*>()(value.Id());
+    }
+};
+
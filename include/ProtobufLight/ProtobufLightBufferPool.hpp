@@ -0,0 +1,181 @@
+/* Copyright (c) 2025 Nemiritngas
+ * All rights reserved.
+ *
+ * Permission is granted to use, copy, and modify this software for personal or educational purposes only.
+ * Commercial use, including but not limited to selling, licensing, or incorporating this software into a
+ * commercial product, is strictly prohibited without the prior written consent of the author.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ */
+
+#include "ProtobufLightReflection.hpp"
+
+#pragma once
+
+namespace ProtobufLight {
+
+class PooledBuffer;
+
+// Per thread free list of serialization buffers. Buffers keep their capacity between uses so the
+// serialize path doesn't allocate once the pool is warm.
+class BufferPool
+{
+public:
+    // Buffers bigger than this are freed instead of being pooled, so one huge message doesn't pin memory.
+    static constexpr size_t DefaultMaxRetainedCapacity = 1024 * 1024;
+    static constexpr size_t DefaultMaxPooledBuffers = 8;
+
+    explicit BufferPool(size_t maxPooledBuffers = DefaultMaxPooledBuffers, size_t maxRetainedCapacity = DefaultMaxRetainedCapacity) :
+        _maxPooledBuffers(maxPooledBuffers),
+        _maxRetainedCapacity(maxRetainedCapacity)
+    {
+        _buffers.reserve(_maxPooledBuffers);
+    }
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    static inline BufferPool& ThreadLocal();
+
+    // Null once the calling thread pool is destroyed, during thread exit after its thread_local teardown
+    static BufferPool* ThreadLocalIfAlive() noexcept
+    {
+        return ThreadLocalDestroyed() ? nullptr : &ThreadLocal();
+    }
+
+    // Returns an empty buffer with at least sizeHint bytes of capacity.
+    inline PooledBuffer Acquire(size_t sizeHint);
+
+    void Release(std::string&& buffer)
+    {
+        if (buffer.capacity() > _maxRetainedCapacity || _buffers.size() >= _maxPooledBuffers)
+            return;
+
+        buffer.clear();
+        _buffers.emplace_back(std::move(buffer));
+    }
+
+    size_t PooledBuffers() const { return _buffers.size(); }
+
+private:
+    friend struct ThreadLocalBufferPool;
+
+    // Trivially destructible, so it stays readable after the thread_local pool itself is gone
+    static bool& ThreadLocalDestroyed() noexcept
+    {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    std::vector<std::string> _buffers;
+    size_t _maxPooledBuffers;
+    size_t _maxRetainedCapacity;
+};
+
+struct ThreadLocalBufferPool
+{
+    BufferPool pool;
+
+    ~ThreadLocalBufferPool() { BufferPool::ThreadLocalDestroyed() = true; }
+};
+
+inline BufferPool& BufferPool::ThreadLocal()
+{
+    thread_local ThreadLocalBufferPool local;
+    return local.pool;
+}
+
+// Owns a buffer borrowed from a BufferPool, the buffer is handed back to the releasing thread pool
+// when the handle is destroyed or Release() is called.
+class PooledBuffer
+{
+public:
+    PooledBuffer() = default;
+    explicit PooledBuffer(std::string&& buffer) : _buffer(std::move(buffer)), _owned(true) {}
+
+    PooledBuffer(PooledBuffer&& other) noexcept :
+        _buffer(std::move(other._buffer)),
+        _owned(std::exchange(other._owned, false))
+    {}
+
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            _buffer = std::move(other._buffer);
+            _owned = std::exchange(other._owned, false);
+        }
+        return *this;
+    }
+
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+
+    ~PooledBuffer() { Release(); }
+
+    void Release()
+    {
+        if (!_owned)
+            return;
+
+        _owned = false;
+        // A handle destroyed after the thread pool during thread exit just frees its buffer
+        if (BufferPool* pool = BufferPool::ThreadLocalIfAlive())
+            pool->Release(std::move(_buffer));
+    }
+
+    std::string& str() noexcept { return _buffer; }
+    const std::string& str() const noexcept { return _buffer; }
+    const uint8_t* data() const noexcept { return reinterpret_cast<const uint8_t*>(_buffer.data()); }
+    size_t size() const noexcept { return _buffer.size(); }
+    std::string_view view() const noexcept { return _buffer; }
+
+private:
+    std::string _buffer;
+    bool _owned = false;
+};
+
+inline PooledBuffer BufferPool::Acquire(size_t sizeHint)
+{
+    std::string buffer;
+    if (!_buffers.empty())
+    {
+        buffer = std::move(_buffers.back());
+        _buffers.pop_back();
+    }
+
+    buffer.reserve(sizeHint);
+    return PooledBuffer{ std::move(buffer) };
+}
+
+namespace Reflection {
+
+namespace Detail {
+
+    // Recent encoded size of T on this thread: it follows growth immediately and decays slowly,
+    // so buffers are reserved once instead of growing through every push_back.
+    template<typename T>
+    size_t& SerializedSizeHint()
+    {
+        thread_local size_t sizeHint = 0;
+        return sizeHint;
+    }
+
+} // namespace Detail
+
+// Serializes obj into a buffer borrowed from the calling thread BufferPool.
+template<typename T>
+PooledBuffer SerializePooled(const T& obj)
+{
+    size_t& sizeHint = Detail::SerializedSizeHint<T>();
+
+    PooledBuffer buffer = BufferPool::ThreadLocal().Acquire(sizeHint);
+    SerializeStruct(obj, buffer.str());
+
+    sizeHint = std::max(buffer.size(), sizeHint - sizeHint / 8);
+    return buffer;
+}
+
+} // namespace Reflection
+} // namespace ProtobufLight
@@ -0,0 +1,175 @@
+/* Copyright (c) 2025 Nemiritngas
+ * All rights reserved.
+ *
+ * Permission is granted to use, copy, and modify this software for personal or educational purposes only.
+ * Commercial use, including but not limited to selling, licensing, or incorporating this software into a
+ * commercial product, is strictly prohibited without the prior written consent of the author.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ */
+
+#include "ProtobufLightReflection.hpp"
+
+#pragma once
+
+namespace ProtobufLight {
+namespace Reflection {
+
+// Struct-of-arrays companion of a message, generated with --columns. It holds one contiguous column per
+// scalar, enum or string field of the row message and one presence bitmap per column:
+//   struct ItemColumns
+//   {
+//       size_t rows{};
+//       std::vector<int32_t> id{};
+//       ProtobufLight::BoolVector id_present{};
+//   };
+// The trait lists the columns like ProtobufTrait lists fields:
+//   template<typename Obj, typename Callback>
+//   static void ForEachColumn(Obj& obj, Callback&& cb) { cb(obj.id, obj.id_present, FieldMeta<1>{"id"}); }
+template<typename T>
+struct ColumnsTrait {};
+
+namespace Detail {
+
+    // Appends the default value of a row that doesn't set this field
+    template<typename Column>
+    void AppendDefault(Column& column)
+    {
+        if constexpr (ProtobufLight::Detail::is_string_list_v<Column>)
+            column.push_back(std::string_view());
+        else if constexpr (ProtobufLight::Detail::is_bool_vector_v<Column>)
+            column.push_back(false);
+        else
+            column.emplace_back();
+    }
+
+    // Decodes a field into the last row of its column, a later occurrence replaces an earlier one
+    template<typename Column>
+    bool ParseLastRow(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size_t size, size_t& idx, Column& column, ParseContext& ctx)
+    {
+        if constexpr (ProtobufLight::Detail::is_string_list_v<Column>)
+        {
+            if (wireType != WireType::LENGTH_DELIMITED)
+                return false;
+
+            std::string_view value;
+            if (!Read(buf, size, idx, value))
+                return false;
+
+            column.pop_back();
+            column.push_back(value);
+            return true;
+        }
+        else if constexpr (ProtobufLight::Detail::is_bool_vector_v<Column>)
+        {
+            bool value = false;
+            if (!ParseField(fieldNumber, wireType, buf, size, idx, value, ctx))
+                return false;
+
+            column.Set(column.size() - 1, value);
+            return true;
+        }
+        else
+        {
+            return ParseField(fieldNumber, wireType, buf, size, idx, column.back(), ctx);
+        }
+    }
+
+    // Decodes an encoded row message into the last row of columns
+    template<typename Columns>
+    bool ParseRow(Columns& columns, const uint8_t* buf, size_t size, ParseContext& ctx)
+    {
+        size_t idx = 0;
+        while (idx < size)
+        {
+            uint32_t fieldNumber = 0;
+            uint8_t wireType = 0;
+            if (!ReadKey(buf, size, idx, fieldNumber, wireType))
+                return false;
+
+            bool fieldHandled = false;
+            bool result = true;
+            ColumnsTrait<Columns>::ForEachColumn(columns, [&](auto& column, auto& present, auto&& meta)
+            {
+                using MetaT = std::decay_t<decltype(meta)>;
+                if (fieldHandled || static_cast<uint32_t>(MetaT::numbers[0]) != fieldNumber)
+                    return;
+
+                fieldHandled = true;
+                result = ParseLastRow(fieldNumber, wireType, buf, size, idx, column, ctx);
+                if (result)
+                    present.Set(present.size() - 1, true);
+            });
+
+            if (!result)
+                return false;
+
+            if (!fieldHandled && !SkipField(wireType, buf, size, idx))
+                return false;
+        }
+
+        return true;
+    }
+
+} // namespace Detail
+
+// Decodes one encoded row message into the next row of columns. Fields without a column are skipped.
+// A row that fails to decode is taken back out, the columns only ever hold complete rows.
+template<typename Columns>
+bool AppendRow(Columns& columns, const uint8_t* buf, size_t size, ParseContext& ctx)
+{
+    ColumnsTrait<Columns>::ForEachColumn(columns, [](auto& column, auto& present, auto&&)
+    {
+        Detail::AppendDefault(column);
+        present.push_back(false);
+    });
+    ++columns.rows;
+
+    if (Detail::ParseRow(columns, buf, size, ctx))
+        return true;
+
+    ColumnsTrait<Columns>::ForEachColumn(columns, [](auto& column, auto& present, auto&&)
+    {
+        column.pop_back();
+        present.pop_back();
+    });
+    --columns.rows;
+    return false;
+}
+
+// Decodes the repeated message field fieldNumber of the message in buf straight into columns,
+// without building the array of row structs. Rows are appended, columns may collect several messages.
+template<typename Columns>
+bool ParseColumns(Columns& columns, const uint8_t* buf, size_t size, uint32_t fieldNumber)
+{
+    ParseContext ctx{};
+    size_t idx = 0;
+    while (idx < size)
+    {
+        uint32_t number = 0;
+        uint8_t wireType = 0;
+        if (!ReadKey(buf, size, idx, number, wireType))
+            return false;
+
+        if (number != fieldNumber || wireType != WireType::LENGTH_DELIMITED)
+        {
+            if (!SkipField(wireType, buf, size, idx))
+                return false;
+
+            continue;
+        }
+
+        const uint8_t* row = nullptr;
+        size_t rowSize = 0;
+        if (!ReadLengthDelimited(buf, size, idx, row, rowSize))
+            return false;
+
+        if (!AppendRow(columns, row, rowSize, ctx))
+            return false;
+    }
+
+    return true;
+}
+
+} // namespace Reflection
+} // namespace ProtobufLight
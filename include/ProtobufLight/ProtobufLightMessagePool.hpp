@@ -0,0 +1,198 @@
+/* Copyright (c) 2025 Nemiritngas
+ * All rights reserved.
+ *
+ * Permission is granted to use, copy, and modify this software for personal or educational purposes only.
+ * Commercial use, including but not limited to selling, licensing, or incorporating this software into a
+ * commercial product, is strictly prohibited without the prior written consent of the author.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ */
+
+#include "ProtobufLightReflection.hpp"
+
+#pragma once
+
+namespace ProtobufLight {
+
+template<typename T>
+class PooledMessage;
+
+struct MessagePoolStats
+{
+    // Acquire calls served from the pool, and the ones that had to allocate a new message
+    size_t hits = 0;
+    size_t misses = 0;
+    // Released messages kept for reuse, and the ones freed because the pool was full or they held too much memory
+    size_t recycled = 0;
+    size_t dropped = 0;
+
+    double HitRate() const noexcept { return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses); }
+};
+
+// Per thread free list of messages of type T. Released messages are cleared with ClearStruct, they
+// keep the capacity of their strings and containers so parsing the next request into them doesn't
+// allocate once the pool is warm.
+template<typename T>
+class MessagePool
+{
+public:
+    // Messages retaining more heap than this are freed instead of being pooled, so one huge message doesn't pin memory.
+    static constexpr size_t DefaultMaxRetainedCapacity = 1024 * 1024;
+    static constexpr size_t DefaultMaxPooledMessages = 8;
+
+    explicit MessagePool(size_t maxPooledMessages = DefaultMaxPooledMessages, size_t maxRetainedCapacity = DefaultMaxRetainedCapacity) :
+        _maxPooledMessages(maxPooledMessages),
+        _maxRetainedCapacity(maxRetainedCapacity)
+    {
+        _messages.reserve(_maxPooledMessages);
+    }
+
+    MessagePool(const MessagePool&) = delete;
+    MessagePool& operator=(const MessagePool&) = delete;
+
+    static inline MessagePool& ThreadLocal();
+
+    // Null once the calling thread pool is destroyed, during thread exit after its thread_local teardown
+    static MessagePool* ThreadLocalIfAlive() noexcept
+    {
+        return ThreadLocalDestroyed() ? nullptr : &ThreadLocal();
+    }
+
+    // Returns a cleared message, a pooled one when there is one.
+    inline PooledMessage<T> Acquire();
+
+    void Release(std::unique_ptr<T> message)
+    {
+        if (!message)
+            return;
+
+        if (_messages.size() >= _maxPooledMessages || Reflection::RetainedCapacity(*message) > _maxRetainedCapacity)
+        {
+            ++_stats.dropped;
+            return;
+        }
+
+        Reflection::ClearStruct(*message);
+        _messages.emplace_back(std::move(message));
+        ++_stats.recycled;
+    }
+
+    size_t PooledMessages() const { return _messages.size(); }
+    const MessagePoolStats& Stats() const noexcept { return _stats; }
+    void ResetStats() noexcept { _stats = MessagePoolStats{}; }
+
+private:
+    template<typename U>
+    friend struct ThreadLocalMessagePool;
+
+    // Trivially destructible, so it stays readable after the thread_local pool itself is gone
+    static bool& ThreadLocalDestroyed() noexcept
+    {
+        thread_local bool destroyed = false;
+        return destroyed;
+    }
+
+    std::vector<std::unique_ptr<T>> _messages;
+    size_t _maxPooledMessages;
+    size_t _maxRetainedCapacity;
+    MessagePoolStats _stats;
+};
+
+template<typename T>
+struct ThreadLocalMessagePool
+{
+    MessagePool<T> pool;
+
+    ~ThreadLocalMessagePool() { MessagePool<T>::ThreadLocalDestroyed() = true; }
+};
+
+template<typename T>
+inline MessagePool<T>& MessagePool<T>::ThreadLocal()
+{
+    thread_local ThreadLocalMessagePool<T> local;
+    return local.pool;
+}
+
+// Owns a message borrowed from a MessagePool, the message is handed back to the releasing thread pool
+// when the handle is destroyed or Release() is called.
+template<typename T>
+class PooledMessage
+{
+public:
+    PooledMessage() = default;
+    explicit PooledMessage(std::unique_ptr<T> message) : _message(std::move(message)) {}
+
+    PooledMessage(PooledMessage&&) noexcept = default;
+
+    PooledMessage& operator=(PooledMessage&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            _message = std::move(other._message);
+        }
+        return *this;
+    }
+
+    PooledMessage(const PooledMessage&) = delete;
+    PooledMessage& operator=(const PooledMessage&) = delete;
+
+    ~PooledMessage() { Release(); }
+
+    void Release()
+    {
+        if (!_message)
+            return;
+
+        // A handle destroyed after the thread pool during thread exit just frees its message
+        if (MessagePool<T>* pool = MessagePool<T>::ThreadLocalIfAlive())
+            pool->Release(std::move(_message));
+        else
+            _message.reset();
+    }
+
+    // Takes the message out of the pool for good
+    std::unique_ptr<T> Detach() noexcept { return std::move(_message); }
+
+    T& Get() noexcept { return *_message; }
+    const T& Get() const noexcept { return *_message; }
+    T& operator*() noexcept { return *_message; }
+    const T& operator*() const noexcept { return *_message; }
+    T* operator->() noexcept { return _message.get(); }
+    const T* operator->() const noexcept { return _message.get(); }
+    explicit operator bool() const noexcept { return _message != nullptr; }
+
+private:
+    std::unique_ptr<T> _message;
+};
+
+template<typename T>
+inline PooledMessage<T> MessagePool<T>::Acquire()
+{
+    if (_messages.empty())
+    {
+        ++_stats.misses;
+        return PooledMessage<T>{ std::make_unique<T>() };
+    }
+
+    ++_stats.hits;
+    std::unique_ptr<T> message = std::move(_messages.back());
+    _messages.pop_back();
+    return PooledMessage<T>{ std::move(message) };
+}
+
+namespace Reflection {
+
+// Parses buf into a message borrowed from the calling thread MessagePool. The handle is empty when parsing fails.
+template<typename T>
+PooledMessage<T> ParsePooled(const uint8_t* buf, size_t size)
+{
+    PooledMessage<T> message = MessagePool<T>::ThreadLocal().Acquire();
+    if (!ParseStruct(*message, buf, size))
+        message.Release();
+
+    return message;
+}
+
+} // namespace Reflection
+} // namespace ProtobufLight
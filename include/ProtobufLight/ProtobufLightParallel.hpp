@@ -0,0 +1,335 @@
+/* Copyright (c) 2025 Nemiritngas
+ * All rights reserved.
+ *
+ * Permission is granted to use, copy, and modify this software for personal or educational purposes only.
+ * Commercial use, including but not limited to selling, licensing, or incorporating this software into a
+ * commercial product, is strictly prohibited without the prior written consent of the author.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ */
+
+#include "ProtobufLightReflection.hpp"
+#include "ProtobufLightThreadPool.hpp"
+
+#pragma once
+
+namespace ProtobufLight {
+namespace Reflection {
+
+struct ParallelOptions
+{
+    // Repeated fields with fewer items are handled on the calling thread.
+    size_t minParallelItems = 4096;
+    // Number of items handled by one executor task.
+    size_t grainSize = 512;
+};
+
+struct BatchParseOptions
+{
+    // Encoded bytes grouped in one task, a message bigger than this gets a task of its own.
+    size_t chunkBytes = 64 * 1024;
+    // Messages grouped in one task at most, however small they are.
+    size_t maxChunkItems = 256;
+};
+
+struct BatchParseResult
+{
+    // succeeded[i] != 0 when input i was parsed into output i
+    std::vector<uint8_t> succeeded;
+    size_t failures = 0;
+
+    bool AllSucceeded() const noexcept { return failures == 0; }
+};
+
+namespace Detail {
+
+    template<typename T>
+    struct is_parallel_repeated_field : std::false_type {};
+
+    template<typename T, typename Alloc>
+    struct is_parallel_repeated_field<std::vector<T, Alloc>> : std::bool_constant<
+        has_protobuf_trait_v<T> || ProtobufLight::Detail::is_byte_container_v<T>> {};
+
+    template<typename T>
+    constexpr bool is_parallel_repeated_field_v = is_parallel_repeated_field<T>::value;
+
+    // Repeated message fields, the ones ParseStruct can split between executor tasks. Only vectors using
+    // std::allocator: the items of a std::pmr::vector allocate from its memory resource, which the
+    // executor tasks would share without synchronization. Those are parsed on the calling thread.
+    template<typename T, typename = void>
+    struct is_parallel_message_field : std::false_type {};
+
+    template<typename T>
+    struct is_parallel_message_field<T, std::enable_if_t<is_parallel_repeated_field_v<T>>> : std::bool_constant<
+        has_protobuf_trait_v<typename T::value_type> &&
+        std::is_same_v<typename T::allocator_type, std::allocator<typename T::value_type>>> {};
+
+    template<typename T>
+    constexpr bool is_parallel_message_field_v = is_parallel_message_field<T>::value;
+
+    // Encoded elements of one repeated message field, found by the pre-scan
+    struct ElementRanges
+    {
+        uint32_t fieldNumber = 0;
+        std::vector<std::string_view> elements;
+    };
+
+    // Parses the pre-scanned elements of a repeated message field. The vector is sized once, then
+    // every element is parsed on the executor in place. Each task has its own ParseContext, the tasks
+    // charge the allocation budget of ctx through one atomic counter.
+    template<typename Vector, typename Executor>
+    bool ParseRepeatedParallel(Vector& items, const std::vector<std::string_view>& elements, Executor& executor, const ParallelOptions& options, ParseContext& ctx)
+    {
+        using ItemT = typename Vector::value_type;
+
+        const size_t first = items.size();
+        if (elements.size() < options.minParallelItems)
+        {
+            for (std::string_view element : elements)
+            {
+                if (!ctx.Charge(sizeof(ItemT)))
+                    return false;
+
+                if (!ParseStruct(items.emplace_back(), reinterpret_cast<const uint8_t*>(element.data()), element.size(), ctx))
+                    return false;
+            }
+            return true;
+        }
+
+        if (!ctx.Charge(elements.size() * sizeof(ItemT)))
+            return false;
+
+        items.resize(first + elements.size());
+
+        std::atomic<size_t> allocatedBytes{ ctx.allocatedBytes };
+        std::atomic<bool> failed{ false };
+        std::atomic<bool> limitExceeded{ false };
+        ParallelFor(executor, elements.size(), options.grainSize, [&](size_t begin, size_t end)
+        {
+            ParseContext itemCtx = ctx;
+            itemCtx.sharedAllocatedBytes = &allocatedBytes;
+
+            for (size_t i = begin; i < end && !failed.load(std::memory_order_relaxed); ++i)
+            {
+                const std::string_view element = elements[i];
+                if (!ParseStruct(items[first + i], reinterpret_cast<const uint8_t*>(element.data()), element.size(), itemCtx))
+                    failed = true;
+            }
+
+            if (itemCtx.limitExceeded)
+                limitExceeded = true;
+        });
+
+        ctx.allocatedBytes = allocatedBytes.load();
+        ctx.limitExceeded = ctx.limitExceeded || limitExceeded.load();
+        return !failed;
+    }
+
+    // Items are sized in parallel, their offsets are the prefix sum of the sizes, then each item is
+    // encoded in its own region of the output. The result is byte identical to SerializeField.
+    template<typename Vector, typename Container, typename Executor>
+    void SerializeRepeatedParallel(uint32_t fieldNumber, const Vector& items, Container& out, Executor& executor, const ParallelOptions& options)
+    {
+        using ItemT = std::decay_t<typename Vector::value_type>;
+
+        const size_t count = items.size();
+        const size_t keySize = KeyEncodedSize(fieldNumber);
+        // Payload size of each item, then the item offsets relative to the field start
+        std::vector<size_t> payloadSizes(count);
+        std::vector<size_t> offsets(count + 1);
+
+        ParallelFor(executor, count, options.grainSize, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if constexpr (has_protobuf_trait_v<ItemT>)
+                    payloadSizes[i] = SerializedStructSize(items[i]);
+                else
+                    payloadSizes[i] = items[i].size();
+            }
+        });
+
+        offsets[0] = 0;
+        for (size_t i = 0; i < count; ++i)
+            offsets[i + 1] = offsets[i] + keySize + VarintEncodedSize(payloadSizes[i]) + payloadSizes[i];
+
+        const size_t base = out.size();
+        out.resize(base + offsets[count]);
+        uint8_t* fieldStart = reinterpret_cast<uint8_t*>(&out[0]) + base;
+
+        ParallelFor(executor, count, options.grainSize, [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                SpanBuffer region(fieldStart + offsets[i], offsets[i + 1] - offsets[i]);
+                WriteKey(fieldNumber, WireType::LENGTH_DELIMITED, region);
+                Write(payloadSizes[i], region);
+                if constexpr (has_protobuf_trait_v<ItemT>)
+                    SerializeStruct(items[i], region);
+                else
+                    region.insert(region.end(), reinterpret_cast<const uint8_t*>(items[i].data()), reinterpret_cast<const uint8_t*>(items[i].data()) + items[i].size());
+
+                assert(region.size() == region.capacity() && "Serialized size doesn't match expected serialized size");
+            }
+        });
+    }
+
+} // namespace Detail
+
+// Same output as SerializeStruct(obj, out), but large repeated message, string and bytes fields
+// of obj are sized and encoded on the executor. Smaller fields are encoded on the calling thread.
+template<typename T, typename Container, typename Executor>
+std::enable_if_t<ProtobufLight::Detail::is_resizable_byte_container_v<Container>> SerializeStruct(const T& obj, Container& out, Executor& executor, const ParallelOptions& options = {})
+{
+    Detail::ForEachSerializedField(obj, [&](auto&& member, auto&& meta)
+    {
+        using MemberT = std::decay_t<decltype(member)>;
+        using MetaT = std::decay_t<decltype(meta)>;
+
+        if constexpr (Detail::is_parallel_repeated_field_v<MemberT>)
+        {
+            if (member.size() >= options.minParallelItems)
+            {
+                Detail::SerializeRepeatedParallel(static_cast<uint32_t>(MetaT::numbers[0]), member, out, executor, options);
+                return;
+            }
+        }
+
+        Detail::SerializeStructMember(member, meta, out);
+    });
+}
+
+// Same result as ParseStruct(obj, buf, size, parseOptions), but the elements of large repeated message
+// fields of obj are parsed on the executor. A pre-scan records the byte range of every element with
+// ReadKey and SkipField, the other fields are parsed on the calling thread meanwhile. The allocation
+// budget of parseOptions covers the recorded ranges and is shared by every task.
+template<typename T, typename Executor>
+std::enable_if_t<ProtobufLight::Detail::is_executor_v<Executor>, bool> ParseStruct(T& obj, const uint8_t* buf, size_t size, Executor& executor,
+    const ParallelOptions& options = {}, const ParseOptions& parseOptions = {})
+{
+    ParseContext ctx{};
+    ctx.options = parseOptions;
+    ctx.depth = 1;
+
+    ClearStruct(obj);
+
+    std::vector<Detail::ElementRanges> ranges;
+    size_t idx = 0;
+    while (idx < size)
+    {
+        uint32_t fieldNumber = 0;
+        uint8_t wireType = 0;
+        if (!ReadKey(buf, size, idx, fieldNumber, wireType))
+            return false;
+
+        bool deferred = false;
+        ProtobufTrait<T>::ForEachField(obj, [&](auto&& member, auto&& meta)
+        {
+            using MemberT = std::decay_t<decltype(member)>;
+            using MetaT = std::decay_t<decltype(meta)>;
+            if constexpr (Detail::is_parallel_message_field_v<MemberT>)
+                deferred = deferred || static_cast<uint32_t>(MetaT::numbers[0]) == fieldNumber;
+        });
+
+        if (deferred && wireType == WireType::LENGTH_DELIMITED)
+        {
+            const uint8_t* element = nullptr;
+            size_t elementSize = 0;
+            if (!ReadLengthDelimited(buf, size, idx, element, elementSize) || !ctx.Charge(sizeof(std::string_view)))
+                return false;
+
+            auto it = std::find_if(ranges.begin(), ranges.end(), [&](const Detail::ElementRanges& r) { return r.fieldNumber == fieldNumber; });
+            if (it == ranges.end())
+                it = ranges.insert(ranges.end(), Detail::ElementRanges{ fieldNumber, {} });
+
+            it->elements.emplace_back(reinterpret_cast<const char*>(element), elementSize);
+            continue;
+        }
+
+        bool fieldHandled = false;
+        if (!Detail::ParseStructField(obj, fieldNumber, wireType, buf, size, idx, ctx, fieldHandled) || ctx.limitExceeded)
+            return false;
+
+        if (!fieldHandled && !SkipField(wireType, buf, size, idx))
+            return false;
+    }
+
+    bool result = true;
+    ProtobufTrait<T>::ForEachField(obj, [&](auto&& member, auto&& meta)
+    {
+        using MemberT = std::decay_t<decltype(member)>;
+        using MetaT = std::decay_t<decltype(meta)>;
+        if constexpr (Detail::is_parallel_message_field_v<MemberT>)
+        {
+            auto it = std::find_if(ranges.begin(), ranges.end(), [&](const Detail::ElementRanges& r) { return r.fieldNumber == static_cast<uint32_t>(MetaT::numbers[0]); });
+            if (result && it != ranges.end())
+                result = Detail::ParseRepeatedParallel(member, it->elements, executor, options, ctx);
+        }
+    });
+
+    Detail::FinalizeStruct(obj);
+    return result;
+}
+
+// Parses inputs[i] into outputs[i] for every message of a batch. Inputs are anything convertible to
+// std::string_view (std::string, SharedBytes...), outputs a random access range of the same size.
+// Consecutive messages are grouped in tasks of about chunkBytes encoded bytes and the biggest tasks
+// are started first, so a large message neither stalls a task full of small ones nor ends the batch
+// alone on one thread. Use a WorkStealingThreadPool to balance batches parsed from executor tasks.
+// Outputs are parsed concurrently: pmr outputs must not share a memory resource that isn't thread safe,
+// such as one std::pmr::monotonic_buffer_resource arena. Throws std::invalid_argument when outputs
+// doesn't hold one message per input.
+template<typename Inputs, typename Outputs, typename Executor>
+std::enable_if_t<ProtobufLight::Detail::is_executor_v<Executor>, BatchParseResult> ParseBatch(const Inputs& inputs, Outputs& outputs, Executor& executor, const BatchParseOptions& options = {})
+{
+    const size_t count = std::size(inputs);
+    if (std::size(outputs) != count)
+        throw std::invalid_argument("ParseBatch needs one output per input");
+
+    BatchParseResult result;
+    result.succeeded.assign(count, 0);
+    if (count == 0)
+        return result;
+
+    // Task t parses messages [bounds[t], bounds[t + 1])
+    std::vector<size_t> bounds{ 0 };
+    std::vector<size_t> taskBytes;
+    size_t bytes = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t messageBytes = std::string_view(inputs[i]).size();
+        if (i != bounds.back() && (bytes + messageBytes > options.chunkBytes || i - bounds.back() >= options.maxChunkItems))
+        {
+            bounds.push_back(i);
+            taskBytes.push_back(bytes);
+            bytes = 0;
+        }
+        bytes += messageBytes;
+    }
+    bounds.push_back(count);
+    taskBytes.push_back(bytes);
+
+    std::vector<size_t> order(taskBytes.size());
+    for (size_t t = 0; t < order.size(); ++t)
+        order[t] = t;
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return taskBytes[a] > taskBytes[b]; });
+
+    ParallelFor(executor, order.size(), 1, [&](size_t begin, size_t end)
+    {
+        for (size_t t = begin; t < end; ++t)
+        {
+            const size_t task = order[t];
+            for (size_t i = bounds[task]; i < bounds[task + 1]; ++i)
+            {
+                const std::string_view input(inputs[i]);
+                result.succeeded[i] = ParseStruct(outputs[i], reinterpret_cast<const uint8_t*>(input.data()), input.size());
+            }
+        }
+    });
+
+    result.failures = static_cast<size_t>(std::count(result.succeeded.begin(), result.succeeded.end(), uint8_t(0)));
+    return result;
+}
+
+} // namespace Reflection
+} // namespace ProtobufLight
@@ -15,15 +15,67 @@
 namespace ProtobufLight {
 namespace Reflection {
 
+// Limits for parsing untrusted input, 0 disables a limit
+struct ParseOptions
+{
+    // Bytes the parser may allocate in total: repeated items, strings, bytes, map entries and recursive nodes.
+    // Counted before each allocation, so a small input declaring millions of items fails early.
+    size_t maxAllocationBytes = 0;
+    // Deepest message nesting, the top-level message counts as depth 1. On by default like protobuf's
+    // recursion limit, a deeply nested input would otherwise overflow the stack.
+    size_t maxDepth = 100;
+};
+
+// State shared by a ParseStruct call and the nested messages it parses
+struct ParseContext
+{
+    // Buffer being parsed when it is shared, SharedBytes fields then keep a slice of it instead of a copy
+    const SharedBytes* source = nullptr;
+    ParseOptions options{};
+    size_t allocatedBytes = 0;
+    // Set when executor tasks parse parts of one message, they then charge one shared budget
+    std::atomic<size_t>* sharedAllocatedBytes = nullptr;
+    size_t depth = 0;
+    // Set when the parse failed because of options rather than malformed input
+    bool limitExceeded = false;
+
+    // Accounts bytes about to be allocated, false once the budget is exceeded
+    constexpr bool Charge(size_t bytes)
+    {
+        if (options.maxAllocationBytes == 0)
+            return true;
+
+        if (sharedAllocatedBytes != nullptr)
+            allocatedBytes = sharedAllocatedBytes->fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        else
+            allocatedBytes += bytes;
+
+        if (allocatedBytes <= options.maxAllocationBytes)
+            return true;
+
+        limitExceeded = true;
+        return false;
+    }
+};
+
 // Forward declaration
 template<typename T>
-bool ParseStruct(T& obj, const uint8_t* buf, size_t size);
+constexpr bool ParseStruct(T& obj, const uint8_t* buf, size_t size);
+
+template<typename T>
+constexpr bool ParseStruct(T& obj, const uint8_t* buf, size_t size, ParseContext& ctx);
+
+template<typename T>
+constexpr bool ParseStruct(T& obj, const uint8_t* buf, size_t size, const ParseOptions& options);
 
 template<typename T, typename Container>
-std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container>> SerializeStruct(const T& obj, Container& out);
+constexpr std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container>> SerializeStruct(const T& obj, Container& out);
+
+template<typename T>
+constexpr size_t SerializedStructSize(const T& obj);
 
 template<typename T>
-size_t SerializedStructSize(const T& obj);
+constexpr void ClearStruct(T& obj);
 
 template<typename T>
 struct ProtobufTrait {
@@ -58,19 +110,101 @@ namespace Detail {
     template <typename T>
     constexpr bool has_protobuf_trait_v = has_protobuf_trait<T>::value;
 
+    template <typename T>
+    auto has_present_fields_impl(int) -> decltype(
+        ProtobufTrait<T>::ForEachPresentField(
+            std::declval<T&>(),
+            AnyFieldVisitor{}
+        ),
+        std::true_type{}
+    );
+
+    template <typename>
+    std::false_type has_present_fields_impl(...);
+
+    // Messages generated with --presence=hasbits also provide ForEachPresentField, which skips unset optional fields
+    template <typename T>
+    constexpr bool has_present_fields_v = decltype(Detail::has_present_fields_impl<T>(0))::value;
+
+    // Visits the fields that may need to be written, in ForEachField order. A const obj is visited
+    // through const members, so the writers never get mutable access to the message.
+    template<typename T, typename Callback>
+    constexpr void ForEachSerializedField(T& obj, Callback&& cb)
+    {
+        using MessageT = std::remove_const_t<T>;
+        if constexpr (has_present_fields_v<MessageT>)
+            ProtobufTrait<MessageT>::ForEachPresentField(obj, std::forward<Callback>(cb));
+        else
+            ProtobufTrait<MessageT>::ForEachField(obj, std::forward<Callback>(cb));
+    }
+
+    // Bytes of a SharedBytes field, a slice of the shared input when there is one, else a copy
+    inline SharedBytes MakeSharedSlice(const ParseContext& ctx, const uint8_t* data, size_t length)
+    {
+        const char* bytes = reinterpret_cast<const char*>(data);
+        if (ctx.source != nullptr && ctx.source->Contains(bytes, length))
+            return ctx.source->Slice(static_cast<size_t>(bytes - ctx.source->data()), length);
+
+        return SharedBytes(std::string(bytes, length));
+    }
+
+    // Charges the length of the length-delimited value at idx before it is copied, idx is left untouched
+    constexpr bool ChargeLengthDelimited(ParseContext& ctx, const uint8_t* buf, size_t size, size_t idx)
+    {
+        if (ctx.options.maxAllocationBytes == 0)
+            return true;
+
+        uint64_t length = 0;
+        if (!DecodeVarint(buf, size, idx, length))
+            return false;
+
+        return ctx.Charge(static_cast<size_t>(length));
+    }
+
     template <typename Alt>
-    bool TryParseVariantAlternative(uint8_t wireType,
+    constexpr bool TryParseVariantAlternative(uint8_t wireType,
                                        const uint8_t* buf, size_t size, size_t& idx,
-                                       Alt& out)
+                                       Alt& out, ParseContext& ctx)
     {
         if constexpr (std::is_same_v<Alt, std::monostate>) {
             return false;
+        } else if constexpr (ProtobufLight::Detail::is_box_v<Alt>) {
+            // The alternative is a new box, its value was allocated with it
+            if (!ctx.Charge(sizeof(typename Alt::value_type)))
+                return false;
+
+            return TryParseVariantAlternative(wireType, buf, size, idx, *out, ctx);
+        } else if constexpr (ProtobufLight::Detail::is_node_ptr_v<Alt>) {
+            if (!ctx.Charge(sizeof(typename Alt::value_type)))
+                return false;
+
+            return TryParseVariantAlternative(wireType, buf, size, idx, out.Mutable(), ctx);
         } else if constexpr (has_protobuf_trait_v<Alt>) {
             std::string_view innerBuf;
             if (!Read(buf, size, idx, innerBuf))
                 return false;
 
-            if (!ParseStruct(out, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size()))
+            if (!ParseStruct(out, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), ctx))
+                return false;
+
+        } else if constexpr (ProtobufLight::Detail::is_shared_bytes_v<Alt>) {
+            const uint8_t* data = nullptr;
+            size_t length = 0;
+            if (!ReadLengthDelimited(buf, size, idx, data, length))
+                return false;
+
+            if (ctx.source == nullptr && !ctx.Charge(length))
+                return false;
+
+            out = MakeSharedSlice(ctx, data, length);
+        } else if constexpr (ProtobufLight::Detail::is_interned_string_v<Alt>) {
+            std::string_view value;
+            if (!Read(buf, size, idx, value) || !ctx.Charge(value.size()))
+                return false;
+
+            out = InternedString(value);
+        } else if constexpr (ProtobufLight::Detail::is_byte_container_v<Alt>) {
+            if (!ChargeLengthDelimited(ctx, buf, size, idx) || !Read(buf, size, idx, out))
                 return false;
 
         } else if (!Read(buf, size, idx, out)) {
@@ -80,13 +214,14 @@ namespace Detail {
     }
 
     template <typename Variant, size_t... Is>
-    bool ParseOneofImpl(Variant& member,
+    constexpr bool ParseOneofImpl(Variant& member,
                           const std::array<int, std::variant_size_v<Variant> - 1>& nums,
                           uint32_t fieldNumber,
                           uint8_t wireType,
                           const uint8_t* buf,
                           size_t size,
                           size_t& idx,
+                          ParseContext& ctx,
                           std::index_sequence<Is...>)
     {
         bool handled = false;
@@ -113,7 +248,7 @@ namespace Detail {
 
                 Alt tmp{};
                 const size_t before = idx;
-                if (!TryParseVariantAlternative<Alt>(wireType, buf, size, idx, tmp))
+                if (!TryParseVariantAlternative<Alt>(wireType, buf, size, idx, tmp, ctx))
                 {
                     idx = before;
                     return;
@@ -127,16 +262,60 @@ namespace Detail {
         return handled;
     }
 
+    // Packed bools are one varint per value, nearly always a single 0x00 or 0x01 byte.
+    // Eight values are checked and turned into bits at once, longer varints fall back to DecodeVarint.
+    template<typename BoolVectorT>
+    bool DecodePackedBools(const uint8_t* data, size_t length, BoolVectorT& value)
+    {
+        constexpr uint64_t HighBits = 0x8080808080808080ull;
+        constexpr uint64_t LowBits = 0x7F7F7F7F7F7F7F7Full;
+        // Multiplying moves bit 0 of byte i to bit 56 + i
+        constexpr uint64_t GatherBits = 0x0102040810204080ull;
+
+        value.reserve(value.size() + length);
+
+        size_t idx = 0;
+        while (idx < length)
+        {
+            if (length - idx >= 8)
+            {
+                // Compilers turn this into a single load on little endian targets
+                uint64_t word = 0;
+                for (size_t i = 0; i < 8; ++i)
+                    word |= static_cast<uint64_t>(data[idx + i]) << (i * 8);
+
+                // No continuation bit: 8 single byte varints
+                if ((word & HighBits) == 0)
+                {
+                    // 0x01 in every non zero byte
+                    const uint64_t nonZero = ((word + LowBits) & HighBits) >> 7;
+                    value.AppendBits((nonZero * GatherBits) >> 56, 8);
+                    idx += 8;
+                    continue;
+                }
+            }
+
+            uint64_t tmp = 0;
+            if (!DecodeVarint(data, length, idx, tmp))
+                return false;
+
+            value.push_back(tmp != 0);
+        }
+
+        return true;
+    }
+
     template <typename Variant>
-    bool ParseOneof(Variant& member,
+    constexpr bool ParseOneof(Variant& member,
                      const std::array<int, std::variant_size_v<Variant> - 1>& nums,
                      uint32_t fieldNumber,
                      uint8_t wireType,
                      const uint8_t* buf,
                      size_t size,
-                     size_t& idx)
+                     size_t& idx,
+                     ParseContext& ctx)
     {
-        return ParseOneofImpl(member, nums, fieldNumber, wireType, buf, size, idx,
+        return ParseOneofImpl(member, nums, fieldNumber, wireType, buf, size, idx, ctx,
                                 std::make_index_sequence<std::variant_size_v<Variant>>{});
     }
 
@@ -153,7 +332,7 @@ constexpr std::array<int, sizeof...(Nums)> FieldMeta<Nums...>::numbers;
 
 
 template<typename T>
-size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
+constexpr size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
 {
     using DecayT = std::decay_t<T>;
 
@@ -164,7 +343,7 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
         if (isVariant || value != DecayT{})
         {
             // Key
-            serializedSize += 1;
+            serializedSize += KeyEncodedSize(fieldNumber);
             // TODO: Choose to encode zigzag or not
             if (true)
                 // Data
@@ -180,7 +359,7 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
         if (isVariant || value != DecayT{})
         {
             // Key // Data
-            serializedSize += 1 + SerializedSize(value);
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(value);
         }
     }
     else if constexpr (ProtobufLight::Detail::is_any_v<DecayT, float, double>)
@@ -188,31 +367,76 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
         if (isVariant || value != DecayT{})
         {
             // Key // Data
-            serializedSize += 1 + SerializedSize(value);
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(value);
         }
     }
     else if constexpr (ProtobufLight::Reflection::Detail::has_protobuf_trait_v<DecayT>)
     {
         const size_t innerSerializedSize = SerializedStructSize(value);
-        // Key // Length // Data
-        serializedSize += 1 + SerializedSize(innerSerializedSize) + innerSerializedSize;
+        // Empty messages are not written unless they are a oneof or repeated item, see SerializeField
+        if (isVariant || innerSerializedSize > 0)
+        {
+            // Key // Length // Data
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(innerSerializedSize) + innerSerializedSize;
+        }
     }
     else if constexpr (ProtobufLight::Detail::is_std_optional_v<DecayT>)
     {
         if (value.has_value())
         {
-            // Key // Data
-            serializedSize += 1 + SerializedFieldSize(fieldNumber, value.value(), false);
+            // A present optional is always written, SerializedFieldSize already has the key
+            serializedSize += SerializedFieldSize(fieldNumber, value.value(), true);
+        }
+    }
+    else if constexpr (ProtobufLight::Detail::is_has_bit_ref_v<DecayT>)
+    {
+        if (value.Has())
+            serializedSize += SerializedFieldSize(fieldNumber, value.Value(), true);
+    }
+    else if constexpr (ProtobufLight::Detail::is_cold_ref_v<DecayT>)
+    {
+        // Cold fields that were never allocated all hold their default value
+        if (value.HasValue())
+            serializedSize += SerializedFieldSize(fieldNumber, value.Value(), isVariant);
+    }
+    else if constexpr (ProtobufLight::Detail::is_bool_ref_v<DecayT>)
+    {
+        serializedSize += SerializedFieldSize(fieldNumber, value.Get(), isVariant);
+    }
+    else if constexpr (ProtobufLight::Detail::is_box_v<DecayT>)
+    {
+        serializedSize += SerializedFieldSize(fieldNumber, *value, isVariant);
+    }
+    else if constexpr (ProtobufLight::Detail::is_node_ptr_v<DecayT>)
+    {
+        // A node has presence like a protobuf submessage, an allocated empty node is still written.
+        // So is a null node selected in a oneof.
+        if (value.HasValue() || isVariant)
+            serializedSize += SerializedFieldSize(fieldNumber, value.Get(), true);
+    }
+    else if constexpr (ProtobufLight::Detail::is_bool_vector_v<DecayT>)
+    {
+        if (isVariant || !value.empty())
+        {
+            // Key // Length // Data, one byte per bool
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(value.size()) + value.size();
         }
     }
-    else if constexpr (ProtobufLight::Detail::is_std_vector_v<DecayT>)
+    else if constexpr (ProtobufLight::Detail::is_string_list_v<DecayT>)
+    {
+        // Key // Length per element, the data adds up to the blob size
+        for (std::string_view item : value)
+            serializedSize += KeyEncodedSize(fieldNumber) + VarintEncodedSize(item.size());
+        serializedSize += value.ByteSize();
+    }
+    else if constexpr (ProtobufLight::Detail::is_repeated_v<DecayT>)
     {
         using DecayItemT = std::decay_t<typename DecayT::value_type>;
 
         if (!isVariant && value.empty())
             return serializedSize;
 
-        if constexpr (ProtobufLight::Detail::is_std_map_v<DecayItemT> ||
+        if constexpr (ProtobufLight::Detail::is_map_v<DecayItemT> ||
             ProtobufLight::Detail::is_std_optional_v<DecayItemT>)
         {
             static_assert(sizeof(T) == 0, "Unsupported repeated field type");
@@ -221,22 +445,23 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
         else if constexpr (ProtobufLight::Reflection::Detail::has_protobuf_trait_v<DecayItemT> ||
             ProtobufLight::Detail::is_byte_container_v<DecayItemT>)
         {
-            // SerializedFieldSize already has the key
+            // SerializedFieldSize already has the key, items are always written even when empty
             for (auto&& item : value)
-                serializedSize += SerializedFieldSize(fieldNumber, item, false);
+                serializedSize += SerializedFieldSize(fieldNumber, item, true);
         }
         // Scalar is serialized as a message pack.
         else
         {
+            // Scalars are copied, std::vector<bool> only hands out proxies
             size_t repeatedLength = 0;
-            for (auto&& item : value)
+            for (const DecayItemT item : value)
                 repeatedLength += SerializedSize(item);
 
             // Key // Length // Data
-            serializedSize += 1 + SerializedSize(repeatedLength) + repeatedLength;
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(repeatedLength) + repeatedLength;
         }
     }
-    else if constexpr (ProtobufLight::Detail::is_std_map_v<DecayT>)
+    else if constexpr (ProtobufLight::Detail::is_map_v<DecayT>)
     {
         // protobuf map is an anonymous message like:
         // message map {
@@ -247,7 +472,7 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
         {
             const size_t mapItemSize = SerializedFieldSize(1, k, false) + SerializedFieldSize(2, v, false);
             // Key // Length // Data
-            serializedSize += 1 + SerializedSize(mapItemSize) + mapItemSize;
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(mapItemSize) + mapItemSize;
         }
     }
     else if constexpr (ProtobufLight::Detail::is_byte_container_v<DecayT>)
@@ -255,7 +480,7 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
         if (isVariant || !value.empty())
         {
             // Key // Length // Data
-            serializedSize += 1 + SerializedSize(value.size()) + value.size();
+            serializedSize += KeyEncodedSize(fieldNumber) + SerializedSize(value.size()) + value.size();
         }
     }
     else
@@ -267,10 +492,10 @@ size_t SerializedFieldSize(uint32_t fieldNumber, T&& value, bool isVariant)
 }
 
 template<typename T>
-size_t SerializedStructSize(const T& obj)
+constexpr size_t SerializedStructSize(const T& obj)
 {
     size_t serializedSize = 0;
-    ProtobufTrait<T>::ForEachField(const_cast<T&>(obj), [&](auto&& member, auto&& meta)
+    Detail::ForEachSerializedField(obj, [&](auto&& member, auto&& meta)
     {
         using MemberT = std::decay_t<decltype(member)>;
         using MetaT = std::decay_t<decltype(meta)>;
@@ -304,7 +529,7 @@ size_t SerializedStructSize(const T& obj)
 template<
     typename T,
     typename Container>
-std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container>> SerializeField(uint32_t fieldNumber, T&& value, Container& out, bool isVariant)
+constexpr std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container>> SerializeField(uint32_t fieldNumber, T&& value, Container& out, bool isVariant)
 {
     using DecayT = std::decay_t<T>;
 
@@ -349,7 +574,7 @@ std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container
     {
         auto innerSize = SerializedStructSize(value);
 
-        if (innerSize > 0)
+        if (isVariant || innerSize > 0)
         {
             WriteKey(fieldNumber, WireType::LENGTH_DELIMITED, out);
             Write(innerSize, out);
@@ -366,14 +591,55 @@ std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container
         if (value.has_value())
             SerializeField(fieldNumber, value.value(), out, true);
     }
-    else if constexpr (ProtobufLight::Detail::is_std_vector_v<DecayT>)
+    else if constexpr (ProtobufLight::Detail::is_has_bit_ref_v<DecayT>)
+    {
+        if (value.Has())
+            SerializeField(fieldNumber, value.Value(), out, true);
+    }
+    else if constexpr (ProtobufLight::Detail::is_cold_ref_v<DecayT>)
+    {
+        if (value.HasValue())
+            SerializeField(fieldNumber, value.Value(), out, isVariant);
+    }
+    else if constexpr (ProtobufLight::Detail::is_bool_ref_v<DecayT>)
+    {
+        SerializeField(fieldNumber, value.Get(), out, isVariant);
+    }
+    else if constexpr (ProtobufLight::Detail::is_box_v<DecayT>)
+    {
+        SerializeField(fieldNumber, *value, out, isVariant);
+    }
+    else if constexpr (ProtobufLight::Detail::is_node_ptr_v<DecayT>)
+    {
+        if (value.HasValue() || isVariant)
+            SerializeField(fieldNumber, value.Get(), out, true);
+    }
+    else if constexpr (ProtobufLight::Detail::is_bool_vector_v<DecayT>)
+    {
+        if (isVariant || !value.empty())
+        {
+            WriteKey(fieldNumber, WireType::LENGTH_DELIMITED, out);
+            Write(value.size(), out);
+            for (bool item : value)
+                out.push_back(item ? 1 : 0);
+        }
+    }
+    else if constexpr (ProtobufLight::Detail::is_string_list_v<DecayT>)
+    {
+        for (std::string_view item : value)
+        {
+            WriteKey(fieldNumber, WireType::LENGTH_DELIMITED, out);
+            Write(item, out);
+        }
+    }
+    else if constexpr (ProtobufLight::Detail::is_repeated_v<DecayT>)
     {
         using DecayItemT = std::decay_t<typename DecayT::value_type>;
 
         if (!isVariant && value.empty())
             return;
 
-        if constexpr (ProtobufLight::Detail::is_std_map_v<DecayItemT> ||
+        if constexpr (ProtobufLight::Detail::is_map_v<DecayItemT> ||
                       ProtobufLight::Detail::is_std_optional_v<DecayItemT>)
         {
             static_assert(sizeof(T) == 0, "Unsupported repeated field type");
@@ -383,22 +649,23 @@ std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container
             ProtobufLight::Detail::is_byte_container_v<DecayItemT>)
         {
             for (auto&& item : value)
-                SerializeField(fieldNumber, item, out, false);
+                SerializeField(fieldNumber, item, out, true);
         }
         // Scalar is serialized as a message pack.
         else
         {
+            // Scalars are copied, std::vector<bool> only hands out proxies
             size_t repeatedLength = 0;
-            for (auto&& item : value)
+            for (const DecayItemT item : value)
                 repeatedLength += SerializedSize(item);
 
             WriteKey(fieldNumber, WireType::LENGTH_DELIMITED, out);
             Write(repeatedLength, out);
-            for (auto&& item : value)
+            for (const DecayItemT item : value)
                 Write(item, out);
         }
     }
-    else if constexpr (ProtobufLight::Detail::is_std_map_v<DecayT>)
+    else if constexpr (ProtobufLight::Detail::is_map_v<DecayT>)
     {
         // protobuf map is an anonymous message like:
         // message map {
@@ -430,13 +697,18 @@ std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container
 }
 
 template<typename T>
-bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size_t size, size_t& idx, T& value)
+constexpr bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size_t size, size_t& idx, T& value, ParseContext& ctx)
 {
     using DecayT = std::decay_t<T>;
 
     if (idx >= size)
     {
-        value = DecayT{};
+        if constexpr (ProtobufLight::Detail::is_has_bit_ref_v<DecayT> ||
+                      ProtobufLight::Detail::is_cold_ref_v<DecayT> ||
+                      ProtobufLight::Detail::is_bool_ref_v<DecayT>)
+            value.Clear();
+        else
+            value = DecayT{};
         return true;
     }
 
@@ -471,17 +743,107 @@ bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size
     }
     else if constexpr (ProtobufLight::Reflection::Detail::has_protobuf_trait_v<DecayT>)
     {
-        std::string_view innerBuf;
-        if (!Read(buf, size, idx, innerBuf))
+        const uint8_t* innerBuf = nullptr;
+        size_t innerSize = 0;
+        if (!ReadLengthDelimited(buf, size, idx, innerBuf, innerSize))
             return false;
 
-        return ParseStruct(value, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size());
+        return ParseStruct(value, innerBuf, innerSize, ctx);
     }
     else if constexpr (ProtobufLight::Detail::is_std_optional_v<DecayT>)
     {
-        return Read(buf, size, idx, value);
+        using ValueT = typename DecayT::value_type;
+        if constexpr (ProtobufLight::Detail::is_shared_bytes_v<ValueT> || ProtobufLight::Detail::is_interned_string_v<ValueT>)
+        {
+            ValueT item;
+            if (!ParseField(fieldNumber, wireType, buf, size, idx, item, ctx))
+                return false;
+
+            value = std::move(item);
+            return true;
+        }
+        else
+        {
+            if (wireType == WireType::LENGTH_DELIMITED && !Detail::ChargeLengthDelimited(ctx, buf, size, idx))
+                return false;
+
+            return Read(buf, size, idx, value);
+        }
+    }
+    else if constexpr (ProtobufLight::Detail::is_has_bit_ref_v<DecayT>)
+    {
+        // Last one wins like std::optional, reset the member before parsing into it
+        value.Clear();
+        if (!ParseField(fieldNumber, wireType, buf, size, idx, value.Value(), ctx))
+            return false;
+
+        value.Set();
+        return true;
+    }
+    else if constexpr (ProtobufLight::Detail::is_cold_ref_v<DecayT>)
+    {
+        return ParseField(fieldNumber, wireType, buf, size, idx, value.Mutable(), ctx);
+    }
+    else if constexpr (ProtobufLight::Detail::is_bool_ref_v<DecayT>)
+    {
+        bool item = false;
+        if (!ParseField(fieldNumber, wireType, buf, size, idx, item, ctx))
+            return false;
+
+        value.Set(item);
+        return true;
+    }
+    else if constexpr (ProtobufLight::Detail::is_box_v<DecayT>)
+    {
+        return ParseField(fieldNumber, wireType, buf, size, idx, *value, ctx);
+    }
+    else if constexpr (ProtobufLight::Detail::is_node_ptr_v<DecayT>)
+    {
+        if (!value.HasValue() && !ctx.Charge(sizeof(typename DecayT::value_type)))
+            return false;
+
+        return ParseField(fieldNumber, wireType, buf, size, idx, value.Mutable(), ctx);
+    }
+    else if constexpr (ProtobufLight::Detail::is_bool_vector_v<DecayT>)
+    {
+        // Unpacked encoding, one key per value
+        if (wireType == WireType::VARINT)
+        {
+            uint64_t tmp = 0;
+            if (!DecodeVarint(buf, size, idx, tmp))
+                return false;
+
+            value.push_back(tmp != 0);
+            return true;
+        }
+
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        if (!ReadLengthDelimited(buf, size, idx, data, length))
+            return false;
+
+        if (!ctx.Charge((length + 7) / 8))
+            return false;
+
+        return Detail::DecodePackedBools(data, length, value);
+    }
+    else if constexpr (ProtobufLight::Detail::is_string_list_v<DecayT>)
+    {
+        if (wireType != WireType::LENGTH_DELIMITED)
+            return false;
+
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        if (!ReadLengthDelimited(buf, size, idx, data, length))
+            return false;
+
+        if (!ctx.Charge(length + sizeof(uint32_t)))
+            return false;
+
+        value.push_back(std::string_view(reinterpret_cast<const char*>(data), length));
+        return true;
     }
-    else if constexpr (ProtobufLight::Detail::is_std_vector_v<DecayT>)
+    else if constexpr (ProtobufLight::Detail::is_repeated_v<DecayT>)
     {
         using ElemT = typename DecayT::value_type;
         std::string_view innerBuf;
@@ -490,37 +852,107 @@ bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size
         
         if constexpr (ProtobufLight::Reflection::Detail::has_protobuf_trait_v<ElemT>)
         {
-            auto& v = value.emplace_back(ElemT{});
-            return ParseStruct(v, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size());
+            if (!ctx.Charge(sizeof(ElemT)))
+                return false;
+
+            // Constructed in place, so allocator-aware containers pass their allocator to the item
+            auto& v = value.emplace_back();
+            return ParseStruct(v, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), ctx);
+        }
+        else if constexpr (ProtobufLight::Detail::is_shared_bytes_v<ElemT>)
+        {
+            if (!ctx.Charge(sizeof(ElemT) + (ctx.source == nullptr ? innerBuf.size() : 0)))
+                return false;
+
+            value.push_back(Detail::MakeSharedSlice(ctx, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size()));
+            return true;
+        }
+        else if constexpr (ProtobufLight::Detail::is_interned_string_v<ElemT>)
+        {
+            if (!ctx.Charge(sizeof(ElemT) + innerBuf.size()))
+                return false;
+
+            value.emplace_back(innerBuf);
+            return true;
         }
         else if constexpr (ProtobufLight::Detail::is_byte_container_v<ElemT>)
         {
+            if (!ctx.Charge(sizeof(ElemT) + innerBuf.size()))
+                return false;
+
             auto& v = value.emplace_back(innerBuf.begin(), innerBuf.end());
             return true;
         }
+        else if constexpr (std::is_enum_v<ElemT>)
+        {
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(innerBuf.data());
+
+            // One varint ends on every byte without the continuation bit
+            size_t count = 0;
+            for (size_t i = 0; i < innerBuf.size(); ++i)
+                count += (data[i] & 0x80) == 0;
+
+            if (!ctx.Charge(count * sizeof(ElemT)))
+                return false;
+
+            value.reserve(value.size() + count);
+
+            size_t innerIdx = 0;
+            while (innerIdx < innerBuf.size())
+            {
+                uint64_t tmp = 0;
+                if (!DecodeVarint(data, innerBuf.size(), innerIdx, tmp))
+                    return false;
+
+                // Decoded straight into the enum storage, values a narrowed enum can't hold are dropped
+                if (ProtobufLight::Detail::EnumValueFits<ElemT>(tmp))
+                    value.push_back(static_cast<ElemT>(static_cast<std::underlying_type_t<ElemT>>(tmp)));
+            }
+            return true;
+        }
+        else if constexpr (std::is_same_v<ElemT, bool>)
+        {
+            if (!ctx.Charge((innerBuf.size() + 7) / 8))
+                return false;
+
+            // std::vector<bool>::emplace_back doesn't return a reference before C++20
+            size_t innerIdx = 0;
+            while (innerIdx < innerBuf.length())
+            {
+                bool item = false;
+                if (!Read(reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), innerIdx, item))
+                    return false;
+
+                value.push_back(item);
+            }
+            return true;
+        }
         else
         {
             size_t innerIdx = 0;
             while (innerIdx < innerBuf.length())
             {
-                auto& v = value.emplace_back(ElemT{});
+                if (!ctx.Charge(sizeof(ElemT)))
+                    return false;
+
+                auto& v = value.emplace_back();
                 if (!Read(reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), innerIdx, v))
                     return false;
             }
             return true;
         }
     }
-    else if constexpr (ProtobufLight::Detail::is_std_map_v<DecayT>)
+    else if constexpr (ProtobufLight::Detail::is_map_v<DecayT>)
     {
-        typename DecayT::key_type key{};
-        typename DecayT::mapped_type v{};
+        auto key = ProtobufLight::Detail::MakeUsingAllocator<typename DecayT::key_type>(value.get_allocator());
+        auto v = ProtobufLight::Detail::MakeUsingAllocator<typename DecayT::mapped_type>(value.get_allocator());
         size_t innerIdx = 0;
         std::string_view innerBuf;
         if (!Read(buf, size, idx, innerBuf))
             return false;
 
-        uint32_t innerFieldNumber;
-        uint8_t innerWireType;
+        uint32_t innerFieldNumber = 0;
+        uint8_t innerWireType = 0;
 
         for (int i = 1; i < 3 && innerIdx < innerBuf.size(); ++i)
         {
@@ -529,12 +961,12 @@ bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size
 
             if (innerFieldNumber == 1)
             {
-                if (!ParseField(innerFieldNumber, innerWireType, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), innerIdx, key))
+                if (!ParseField(innerFieldNumber, innerWireType, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), innerIdx, key, ctx))
                     return false;
             }
             else if (innerFieldNumber == 2)
             {
-                if (!ParseField(innerFieldNumber, innerWireType, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), innerIdx, v))
+                if (!ParseField(innerFieldNumber, innerWireType, reinterpret_cast<const uint8_t*>(innerBuf.data()), innerBuf.size(), innerIdx, v, ctx))
                     return false;
             }
             else
@@ -543,7 +975,44 @@ bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size
             }
         }
 
-        value.emplace(std::move(key), std::move(v));
+        if (!ctx.Charge(sizeof(typename DecayT::value_type)))
+            return false;
+
+        // Like protobuf, the last entry of a duplicated key wins
+        if constexpr (ProtobufLight::Detail::is_flat_map_v<DecayT>)
+            value.AppendUnsorted(std::move(key), std::move(v));
+        else
+            value.insert_or_assign(std::move(key), std::move(v));
+        return true;
+    }
+    else if constexpr (ProtobufLight::Detail::is_shared_bytes_v<DecayT>)
+    {
+        if (wireType != WireType::LENGTH_DELIMITED)
+            return false;
+
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+        if (!ReadLengthDelimited(buf, size, idx, data, length))
+            return false;
+
+        // Only a copy allocates, a slice of the shared source doesn't
+        if (ctx.source == nullptr && !ctx.Charge(length))
+            return false;
+
+        value = Detail::MakeSharedSlice(ctx, data, length);
+        return true;
+    }
+    else if constexpr (ProtobufLight::Detail::is_interned_string_v<DecayT>)
+    {
+        if (wireType != WireType::LENGTH_DELIMITED)
+            return false;
+
+        // Only a lookup once the value is in the table, but a new value allocates its entry
+        std::string_view item;
+        if (!Read(buf, size, idx, item) || !ctx.Charge(item.size()))
+            return false;
+
+        value = InternedString(item);
         return true;
     }
     else if constexpr (ProtobufLight::Detail::is_appendable_byte_container_v<DecayT>)
@@ -551,6 +1020,9 @@ bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size
         if (wireType != WireType::LENGTH_DELIMITED)
             return false;
 
+        if (!Detail::ChargeLengthDelimited(ctx, buf, size, idx))
+            return false;
+
         return Read(buf, size, idx, value);
     }
     else
@@ -561,15 +1033,14 @@ bool ParseField(uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size
     return false;
 }
 
-template<typename T, typename Container>
-std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container>> SerializeStruct(const T& obj, Container& out)
-{
-    ProtobufTrait<T>::ForEachField(const_cast<T&>(obj), [&](auto&& member, auto&& meta)
+namespace Detail {
+
+    // Serializes one ForEachField member, plain field or oneof.
+    template<typename MemberT, typename MetaT, typename Container>
+    constexpr void SerializeStructMember(const MemberT& member, const MetaT&, Container& out)
     {
-        using MemberT = std::decay_t<decltype(member)>;
-        using MetaT = std::decay_t<decltype(meta)>;
         constexpr auto& nums = MetaT::numbers;
-        
+
         if constexpr (!ProtobufLight::Detail::is_variant_v<MemberT>)
         {
             static_assert(!nums.empty(), "FieldMeta must have at least one field number");
@@ -595,31 +1066,574 @@ std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container
                 }
             }, member);
         }
+    }
+
+} // namespace Detail
+
+template<typename T, typename Container>
+constexpr std::enable_if_t<ProtobufLight::Detail::is_appendable_byte_container_v<Container>> SerializeStruct(const T& obj, Container& out)
+{
+    Detail::ForEachSerializedField(obj, [&](auto&& member, auto&& meta)
+    {
+        Detail::SerializeStructMember(member, meta, out);
     });
 }
 
-template<typename T>
-bool ParseStruct(T& obj, const uint8_t* buf, size_t size)
+// Serializes obj into an array of exactly N bytes, N is usually SerializedStructSize(obj).
+// Messages made only of literal types (scalars, enums, optionals and nested scalar messages)
+// can be encoded in a constant expression:
+//   constexpr LeafLight leaf{ 42 };
+//   constexpr auto bytes = SerializeToArray<SerializedStructSize(leaf)>(leaf);
+template<size_t N, typename T>
+constexpr std::array<uint8_t, N> SerializeToArray(const T& obj)
 {
-    size_t idx = 0;
-    auto result = true;
+    StaticBuffer<N> out;
+    SerializeStruct(obj, out);
+    if (out.size() != N)
+        throw std::length_error("Serialized size doesn't match the array size");
 
-    obj = T{};
-    while (idx < size)
+    return out.array();
+}
+
+namespace Detail {
+
+    template<typename T>
+    constexpr std::optional<size_t> MaxSerializedStructSize();
+
+    template<typename T>
+    constexpr std::optional<size_t> MaxSerializedFieldSize(uint32_t fieldNumber)
     {
-        uint32_t fieldNumber;
-        uint8_t wireType;
-        if (!ReadKey(buf, size, idx, fieldNumber, wireType))
-            return false;
+        using DecayT = std::decay_t<T>;
 
-        bool fieldHandled = false;
+        if constexpr (ProtobufLight::Detail::is_any_v<DecayT, int32_t, int64_t, uint64_t, size_t>)
+        {
+            // Negative int32 are sign extended to 64 bits on the wire
+            return KeyEncodedSize(fieldNumber) + VarintEncodedSize(std::numeric_limits<uint64_t>::max());
+        }
+        else if constexpr (std::is_same_v<DecayT, uint32_t>)
+        {
+            return KeyEncodedSize(fieldNumber) + VarintEncodedSize(std::numeric_limits<uint32_t>::max());
+        }
+        else if constexpr (std::is_same_v<DecayT, bool> || ProtobufLight::Detail::is_bool_ref_v<DecayT>)
+        {
+            return KeyEncodedSize(fieldNumber) + 1;
+        }
+        else if constexpr (std::is_enum_v<DecayT>)
+        {
+            using U = std::underlying_type_t<DecayT>;
+            if constexpr (std::is_signed_v<U>)
+                return KeyEncodedSize(fieldNumber) + VarintEncodedSize(std::numeric_limits<uint64_t>::max());
+            else
+                return KeyEncodedSize(fieldNumber) + VarintEncodedSize(std::numeric_limits<U>::max());
+        }
+        else if constexpr (ProtobufLight::Detail::is_any_v<DecayT, float, double>)
+        {
+            return KeyEncodedSize(fieldNumber) + sizeof(DecayT);
+        }
+        else if constexpr (ProtobufLight::Detail::is_std_optional_v<DecayT> ||
+                           ProtobufLight::Detail::is_has_bit_ref_v<DecayT>)
+        {
+            return MaxSerializedFieldSize<typename DecayT::value_type>(fieldNumber);
+        }
+        else if constexpr (has_protobuf_trait_v<DecayT>)
+        {
+            constexpr std::optional<size_t> innerSize = MaxSerializedStructSize<DecayT>();
+            if constexpr (innerSize.has_value())
+                return KeyEncodedSize(fieldNumber) + VarintEncodedSize(*innerSize) + *innerSize;
+            else
+                return std::nullopt;
+        }
+        else
+        {
+            // Strings, bytes, repeated fields and maps have no upper bound
+            return std::nullopt;
+        }
+    }
+
+    template<typename Variant, typename MetaT, size_t... Is>
+    constexpr std::optional<size_t> MaxSerializedOneofSize(std::index_sequence<Is...>)
+    {
+        // Alternative 0 is std::monostate, alternative I uses the field number I-1
+        constexpr std::optional<size_t> sizes[] = {
+            MaxSerializedFieldSize<std::variant_alternative_t<Is + 1, Variant>>(static_cast<uint32_t>(MetaT::numbers[Is]))...
+        };
+
+        size_t maxSize = 0;
+        for (const auto& size : sizes)
+        {
+            if (!size.has_value())
+                return std::nullopt;
+
+            maxSize = std::max(maxSize, *size);
+        }
+        return maxSize;
+    }
+
+    template<typename T>
+    constexpr std::optional<size_t> MaxSerializedStructSize()
+    {
+        // Every unbounded field type (strings, containers) has a non-trivial destructor, so a trivially
+        // destructible message only holds bounded fields and can be instantiated in a constant expression.
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            return std::nullopt;
+        }
+        else
+        {
+            T obj{};
+            size_t maxSize = 0;
+            bool bounded = true;
+            ProtobufTrait<T>::ForEachField(obj, [&](auto&& member, auto&& meta)
+            {
+                using MemberT = std::decay_t<decltype(member)>;
+                using MetaT = std::decay_t<decltype(meta)>;
+
+                std::optional<size_t> fieldSize;
+                if constexpr (ProtobufLight::Detail::is_variant_v<MemberT>)
+                {
+                    ProtobufLight::Detail::ValidateFieldmetaVariant<MemberT, MetaT>();
+                    fieldSize = MaxSerializedOneofSize<MemberT, MetaT>(std::make_index_sequence<std::variant_size_v<MemberT> - 1>{});
+                }
+                else
+                {
+                    fieldSize = MaxSerializedFieldSize<MemberT>(static_cast<uint32_t>(MetaT::numbers[0]));
+                }
+
+                if (fieldSize.has_value())
+                    maxSize += *fieldSize;
+                else
+                    bounded = false;
+            });
+
+            if (!bounded)
+                return std::nullopt;
+
+            return maxSize;
+        }
+    }
+
+} // namespace Detail
+
+// Upper bound of the encoded size of T, std::nullopt when T has unbounded fields.
+template<typename T>
+struct MaxSerializedSize
+{
+    static constexpr std::optional<size_t> value = Detail::MaxSerializedStructSize<T>();
+};
+
+template<typename T>
+constexpr std::optional<size_t> MaxSerializedSize_v = MaxSerializedSize<T>::value;
+
+// Serializes a bounded message into a stack buffer of MaxSerializedSize_v<T> bytes: no heap allocation,
+// no sizing pass and no bounds checks, only nested messages are sized for their length prefix.
+template<typename T>
+constexpr auto SerializeToStaticBuffer(const T& obj)
+{
+    static_assert(MaxSerializedSize_v<T>.has_value(), "SerializeToStaticBuffer requires a message without strings, bytes, repeated or map fields");
+
+    // The bound holds for every value of T, so the buffer can't overflow
+    StaticBuffer<MaxSerializedSize_v<T>.value_or(0), false> out;
+    SerializeStruct(obj, out);
+    return out;
+}
+
+// Messages encoded back to back, each one prefixed by its varint length (protobuf delimited framing).
+struct SerializedBatch
+{
+    std::string buffer;
+    // Message i frame (length prefix + payload) is [offsets[i], offsets[i + 1]), offsets.back() == buffer.size()
+    std::vector<size_t> offsets;
+
+    size_t size() const noexcept { return offsets.empty() ? 0 : offsets.size() - 1; }
+
+    // Payload of message i, without its length prefix. Throws ParseError when the frame is corrupted.
+    std::string_view Message(size_t i) const
+    {
+        size_t idx = offsets[i];
+        uint64_t length = 0;
+        if (!DecodeVarint(reinterpret_cast<const uint8_t*>(buffer.data()), offsets[i + 1], idx, length) || length != offsets[i + 1] - idx)
+            throw ParseError("Corrupted SerializedBatch frame");
+
+        return std::string_view{ buffer.data() + idx, static_cast<size_t>(length) };
+    }
+};
+
+// Encodes a range of messages of the same type: one sizing pass, one allocation, then every
+// message is written in place without growing the buffer.
+template<typename Iterator>
+SerializedBatch SerializeBatch(Iterator first, Iterator last)
+{
+    SerializedBatch batch;
+    const size_t count = static_cast<size_t>(std::distance(first, last));
+    batch.offsets.resize(count + 1);
+
+    // First pass stores message i size in offsets[i + 1], the second pass turns them into offsets.
+    size_t totalSize = 0;
+    size_t i = 0;
+    for (auto it = first; it != last; ++it, ++i)
+    {
+        const size_t messageSize = SerializedStructSize(*it);
+        batch.offsets[i + 1] = messageSize;
+        totalSize += VarintEncodedSize(messageSize) + messageSize;
+    }
+
+    batch.buffer.resize(totalSize);
+    SpanBuffer out(reinterpret_cast<uint8_t*>(&batch.buffer[0]), totalSize);
+
+    i = 0;
+    for (auto it = first; it != last; ++it, ++i)
+    {
+        const size_t messageSize = batch.offsets[i + 1];
+        Write(messageSize, out);
+        SerializeStruct(*it, out);
+        batch.offsets[i + 1] = out.size();
+    }
+
+    assert(out.size() == totalSize && "Serialized size doesn't match expected serialized size");
+    return batch;
+}
+
+template<typename Range>
+SerializedBatch SerializeBatch(const Range& messages)
+{
+    return SerializeBatch(std::begin(messages), std::end(messages));
+}
+
+namespace Detail {
+
+    // Resets one ForEachField member to its default value. Containers are emptied but keep their capacity.
+    template<typename T>
+    constexpr void ClearField(T&& value)
+    {
+        using DecayT = std::decay_t<T>;
+
+        if constexpr (has_protobuf_trait_v<DecayT>)
+        {
+            ClearStruct(value);
+        }
+        else if constexpr (ProtobufLight::Detail::is_std_optional_v<DecayT>)
+        {
+            // Assigned rather than reset(), the trivial assignment stays usable in constant expressions
+            value = DecayT{};
+        }
+        else if constexpr (ProtobufLight::Detail::is_has_bit_ref_v<DecayT>)
+        {
+            ClearField(value.Value());
+            value.Unset();
+        }
+        else if constexpr (ProtobufLight::Detail::is_cold_ref_v<DecayT>)
+        {
+            if (value.HasValue())
+                ClearField(value.Mutable());
+        }
+        else if constexpr (ProtobufLight::Detail::is_bool_ref_v<DecayT>)
+        {
+            value.Clear();
+        }
+        else if constexpr (ProtobufLight::Detail::is_box_v<DecayT>)
+        {
+            ClearField(*value);
+        }
+        else if constexpr (ProtobufLight::Detail::is_node_ptr_v<DecayT>)
+        {
+            value.Reset();
+        }
+        else if constexpr (ProtobufLight::Detail::is_variant_v<DecayT>)
+        {
+            value = std::monostate{};
+        }
+        else if constexpr (ProtobufLight::Detail::is_shared_bytes_v<DecayT> ||
+                           ProtobufLight::Detail::is_interned_string_v<DecayT>)
+        {
+            value = DecayT{};
+        }
+        else if constexpr (ProtobufLight::Detail::is_bool_vector_v<DecayT> ||
+                           ProtobufLight::Detail::is_string_list_v<DecayT> ||
+                           ProtobufLight::Detail::is_repeated_v<DecayT> ||
+                           ProtobufLight::Detail::is_map_v<DecayT> ||
+                           ProtobufLight::Detail::is_byte_container_v<DecayT>)
+        {
+            value.clear();
+        }
+        else
+        {
+            value = DecayT{};
+        }
+    }
+
+    // Reports every heap block a field owns to acc: acc.Block(kind, used, slack), slack being reserved
+    // but unused capacity. Nested message fields are wrapped in acc.Enter(name) / acc.Leave().
+    template<typename T, typename Accounter>
+    void AccountField(const T& value, Accounter& acc)
+    {
+        if constexpr (has_protobuf_trait_v<T>)
+        {
+            ProtobufTrait<T>::ForEachField(value, [&](auto&& member, auto&& meta)
+            {
+                acc.Enter(meta.name);
+                AccountField(member, acc);
+                acc.Leave();
+            });
+        }
+        else if constexpr (ProtobufLight::Detail::is_std_optional_v<T>)
+        {
+            if (value.has_value())
+                AccountField(*value, acc);
+        }
+        else if constexpr (ProtobufLight::Detail::is_has_bit_ref_v<T>)
+        {
+            AccountField(value.Value(), acc);
+        }
+        else if constexpr (ProtobufLight::Detail::is_cold_ref_v<T>)
+        {
+            if (value.HasValue())
+                AccountField(value.Value(), acc);
+        }
+        else if constexpr (ProtobufLight::Detail::is_box_v<T>)
+        {
+            acc.Block("box", sizeof(*value), 0);
+            AccountField(*value, acc);
+        }
+        else if constexpr (ProtobufLight::Detail::is_node_ptr_v<T>)
+        {
+            if (value.HasValue())
+            {
+                acc.Block("node", sizeof(value.Get()), 0);
+                AccountField(value.Get(), acc);
+            }
+        }
+        else if constexpr (ProtobufLight::Detail::is_variant_v<T>)
+        {
+            std::visit([&](const auto& v)
+            {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(v)>, std::monostate>)
+                    AccountField(v, acc);
+            }, value);
+        }
+        else if constexpr (ProtobufLight::Detail::is_shared_bytes_v<T>)
+        {
+            // Only the bytes this slice keeps alive, the owner may pin a larger buffer
+            acc.Block("shared bytes", value.size(), 0);
+        }
+        else if constexpr (ProtobufLight::Detail::is_interned_string_v<T>)
+        {
+            // The bytes belong to the intern table, the field holds no heap of its own
+        }
+        else if constexpr (ProtobufLight::Detail::is_bool_vector_v<T>)
+        {
+            const size_t used = (value.size() + 63) / 64 * sizeof(uint64_t);
+            acc.Block("bool vector", used, value.CapacityBytes() - used);
+        }
+        else if constexpr (ProtobufLight::Detail::is_string_list_v<T>)
+        {
+            const size_t used = value.ByteSize() + value.size() * sizeof(uint32_t);
+            acc.Block("string list", used, value.CapacityBytes() - used);
+        }
+        else if constexpr (ProtobufLight::Detail::is_repeated_v<T>)
+        {
+            using ItemT = typename T::value_type;
+
+            bool onHeap = true;
+            if constexpr (ProtobufLight::Detail::is_small_vector_v<T>)
+                onHeap = !value.IsInline();
+
+            if (onHeap)
+                acc.Block("repeated", value.size() * sizeof(ItemT), (value.capacity() - value.size()) * sizeof(ItemT));
+
+            if constexpr (!std::is_arithmetic_v<ItemT> && !std::is_enum_v<ItemT>)
+            {
+                for (const auto& item : value)
+                    AccountField(item, acc);
+            }
+        }
+        else if constexpr (ProtobufLight::Detail::is_map_v<T>)
+        {
+            using EntryT = typename T::value_type;
+
+            if constexpr (ProtobufLight::Detail::is_flat_map_v<T>)
+                acc.Block("map", value.size() * sizeof(EntryT), value.CapacityBytes() - value.size() * sizeof(EntryT));
+            else
+                // Node based maps are counted as one node of two pointers per entry
+                acc.Block("map", value.size() * (sizeof(EntryT) + 2 * sizeof(void*)), 0);
+
+            for (const auto& [k, v] : value)
+            {
+                acc.Enter("key");
+                AccountField(k, acc);
+                acc.Leave();
+                acc.Enter("value");
+                AccountField(v, acc);
+                acc.Leave();
+            }
+        }
+        else if constexpr (ProtobufLight::Detail::is_byte_container_v<T>)
+        {
+            // Short strings live inside the object
+            const auto* object = reinterpret_cast<const char*>(&value);
+            const auto* data = reinterpret_cast<const char*>(value.data());
+            if (std::less_equal<const char*>()(object, data) && std::less<const char*>()(data, object + sizeof(T)))
+                return;
+
+            constexpr size_t itemSize = sizeof(*value.data());
+            acc.Block("string", value.size() * itemSize, (value.capacity() - value.size()) * itemSize);
+        }
+    }
+
+    // Accounter of RetainedCapacity, only sums
+    struct CapacityAccounter
+    {
+        size_t capacity = 0;
+
+        void Block(std::string_view, size_t used, size_t slack) noexcept { capacity += used + slack; }
+        void Enter(std::string_view) noexcept {}
+        void Leave() noexcept {}
+    };
+
+} // namespace Detail
+
+// Resets obj to a default constructed message without releasing the capacity of its containers,
+// so parsing into it again only allocates for what outgrows the previous message.
+// Nested messages of repeated fields, oneof alternatives and recursive nodes are destroyed.
+template<typename T>
+constexpr void ClearStruct(T& obj)
+{
+    ProtobufTrait<T>::ForEachField(obj, [](auto&& member, auto&&)
+    {
+        Detail::ClearField(member);
+    });
+}
+
+// Heap bytes obj holds on to, reserved capacity included. Node based containers are estimated.
+template<typename T>
+size_t RetainedCapacity(const T& obj)
+{
+    Detail::CapacityAccounter acc;
+    Detail::AccountField(obj, acc);
+    return acc.capacity;
+}
+
+struct SpaceUsage
+{
+    size_t used = 0;
+    // Reserved capacity that holds no element
+    size_t slack = 0;
+
+    size_t Total() const noexcept { return used + slack; }
+};
+
+// Memory held by a message, see SpaceUsed
+struct SpaceUsedReport
+{
+    // sizeof the message itself, nested messages stored by value included
+    size_t shallow = 0;
+    SpaceUsage heap;
+    // Heap blocks by field path, "items.name" sums the names of every element of items.
+    // Map keys and values are reported under "<map>.key" and "<map>.value".
+    std::map<std::string, SpaceUsage, std::less<>> byField;
+    // Heap blocks by storage kind: "string", "repeated", "map", "string list", "bool vector", "box", "node", "shared bytes"
+    std::map<std::string, SpaceUsage, std::less<>> byKind;
+
+    size_t Total() const noexcept { return shallow + heap.Total(); }
+};
+
+namespace Detail {
+
+    struct SpaceUsedAccounter
+    {
+        SpaceUsedReport& report;
+        std::string path;
+        std::vector<size_t> pathLengths;
+
+        void Block(std::string_view kind, size_t used, size_t slack)
+        {
+            if (used + slack == 0)
+                return;
+
+            for (SpaceUsage* usage : { &report.heap, &Entry(report.byField, path), &Entry(report.byKind, kind) })
+            {
+                usage->used += used;
+                usage->slack += slack;
+            }
+        }
+
+        void Enter(std::string_view name)
+        {
+            pathLengths.push_back(path.size());
+            if (!path.empty())
+                path += '.';
+            path += name;
+        }
+
+        void Leave()
+        {
+            path.resize(pathLengths.back());
+            pathLengths.pop_back();
+        }
+
+        static SpaceUsage& Entry(std::map<std::string, SpaceUsage, std::less<>>& entries, std::string_view key)
+        {
+            auto it = entries.find(key);
+            if (it == entries.end())
+                it = entries.emplace(std::string(key), SpaceUsage{}).first;
+            return it->second;
+        }
+    };
+
+} // namespace Detail
+
+// Heap used by obj, walked through ProtobufTrait::ForEachField: string buffers, container capacity
+// and map nodes, reported by field path and by storage kind. Interned strings belong to the intern
+// table and are not counted.
+template<typename T>
+SpaceUsedReport SpaceUsed(const T& obj)
+{
+    SpaceUsedReport report;
+    report.shallow = sizeof(T);
+
+    Detail::SpaceUsedAccounter acc{ report, {}, {} };
+    Detail::AccountField(obj, acc);
+    return report;
+}
+
+template<typename T>
+constexpr bool ParseStruct(T& obj, const uint8_t* buf, size_t size)
+{
+    ParseContext ctx{};
+    return ParseStruct(obj, buf, size, ctx);
+}
+
+// Parses a message held in a shared buffer. SharedBytes fields keep a slice of buffer instead of
+// copying their bytes, and keep it alive once parsing is done.
+template<typename T>
+bool ParseStruct(T& obj, const SharedBytes& buffer)
+{
+    ParseContext ctx{ &buffer };
+    return ParseStruct(obj, reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), ctx);
+}
+
+// Parses untrusted input within the limits of options
+template<typename T>
+constexpr bool ParseStruct(T& obj, const uint8_t* buf, size_t size, const ParseOptions& options)
+{
+    ParseContext ctx{};
+    ctx.options = options;
+    return ParseStruct(obj, buf, size, ctx);
+}
+
+namespace Detail {
+
+    // Parses one field of obj, sets fieldHandled when obj has a member for fieldNumber.
+    template<typename T>
+    constexpr bool ParseStructField(T& obj, uint32_t fieldNumber, uint8_t wireType, const uint8_t* buf, size_t size, size_t& idx, ParseContext& ctx, bool& fieldHandled)
+    {
+        bool result = true;
 
         ProtobufTrait<T>::ForEachField(obj, [&](auto&& member, auto&& meta)
         {
             using MemberT = std::decay_t<decltype(member)>;
             using MetaT = std::decay_t<decltype(meta)>;
 
-            if (fieldHandled && !ProtobufLight::Detail::is_std_vector_v<MemberT>)
+            if (fieldHandled && !ProtobufLight::Detail::is_repeated_v<MemberT>)
                 return;
 
             constexpr auto& nums = MetaT::numbers;
@@ -632,7 +1646,7 @@ bool ParseStruct(T& obj, const uint8_t* buf, size_t size)
                 {
                     if constexpr (!ProtobufLight::Detail::is_variant_v<MemberT>)
                     {
-                        if (!ParseField(fieldNumber, wireType, buf, size, idx, member))
+                        if (!ParseField(fieldNumber, wireType, buf, size, idx, member, ctx))
                         {
                             idx = idxBackup;
                             result = false;
@@ -640,7 +1654,7 @@ bool ParseStruct(T& obj, const uint8_t* buf, size_t size)
                     }
                     else
                     {
-                        if (!Detail::ParseOneof(member, nums, fieldNumber, wireType, buf, size, idx))
+                        if (!ParseOneof(member, nums, fieldNumber, wireType, buf, size, idx, ctx))
                         {
                             member = std::monostate{};
                         }
@@ -651,15 +1665,154 @@ bool ParseStruct(T& obj, const uint8_t* buf, size_t size)
             }
         });
 
+        return result;
+    }
+
+    // Flat maps are appended to while parsing, sort them once every entry is in
+    template<typename T>
+    constexpr void FinalizeStruct(T& obj)
+    {
+        ProtobufTrait<T>::ForEachField(obj, []([[maybe_unused]] auto&& member, auto&&)
+        {
+            using MemberT = std::decay_t<decltype(member)>;
+            if constexpr (ProtobufLight::Detail::is_flat_map_v<MemberT>)
+            {
+                member.Finalize();
+            }
+            else if constexpr (ProtobufLight::Detail::is_cold_ref_v<MemberT>)
+            {
+                if constexpr (ProtobufLight::Detail::is_flat_map_v<typename MemberT::value_type>)
+                {
+                    if (member.HasValue())
+                        member.Mutable().Finalize();
+                }
+            }
+        });
+    }
+
+} // namespace Detail
+
+template<typename T>
+constexpr bool ParseStruct(T& obj, const uint8_t* buf, size_t size, ParseContext& ctx)
+{
+    size_t idx = 0;
+    auto result = true;
+
+    if (ctx.options.maxDepth != 0 && ctx.depth >= ctx.options.maxDepth)
+    {
+        ctx.limitExceeded = true;
+        return false;
+    }
+    ++ctx.depth;
+
+    ClearStruct(obj);
+    while (idx < size)
+    {
+        uint32_t fieldNumber = 0;
+        uint8_t wireType = 0;
+        if (!ReadKey(buf, size, idx, fieldNumber, wireType))
+        {
+            result = false;
+            break;
+        }
+
+        bool fieldHandled = false;
+        result = Detail::ParseStructField(obj, fieldNumber, wireType, buf, size, idx, ctx, fieldHandled);
+
+        // Stop at the first bad field instead of reading its payload as keys
+        if (!result || ctx.limitExceeded)
+        {
+            result = false;
+            break;
+        }
+
         if (!fieldHandled)
         {
             if (!SkipField(wireType, buf, size, idx))
-                return false;
+            {
+                result = false;
+                break;
+            }
         }
     }
 
+    Detail::FinalizeStruct(obj);
+
+    --ctx.depth;
     return result;
 }
 
 } // namespace Reflection
+
+// Immutable, ref-counted message that can be published to any number of threads. Copies share the
+// message. The encoding is computed once, by the first thread asking for it, and every later
+// serialization of the frozen message appends these bytes.
+template<typename T>
+class Frozen
+{
+public:
+    using value_type = T;
+
+    Frozen() : Frozen(T{}) {}
+    explicit Frozen(T value) : _state(std::make_shared<const State>(std::move(value))) {}
+
+    // No move operations: moving would leave an empty handle, a copy only bumps the reference count
+    Frozen(const Frozen&) = default;
+    Frozen& operator=(const Frozen&) = default;
+
+    const T& Get() const noexcept { return _state->value; }
+    const T& operator*() const noexcept { return _state->value; }
+    const T* operator->() const noexcept { return &_state->value; }
+
+    size_t ByteSize() const { return Encoded().size(); }
+
+    // Encoded message, kept alive by the returned slice even once every Frozen copy is gone
+    SharedBytes Bytes() const
+    {
+        const std::string& bytes = Encoded();
+        return SharedBytes(std::shared_ptr<const void>(_state, &bytes), bytes.data(), bytes.size());
+    }
+
+    template<typename Container>
+    std::enable_if_t<Detail::is_appendable_byte_container_v<Container>> SerializeTo(Container& out) const
+    {
+        using ByteT = typename Container::value_type;
+        const std::string& bytes = Encoded();
+        out.insert(out.end(), reinterpret_cast<const ByteT*>(bytes.data()), reinterpret_cast<const ByteT*>(bytes.data()) + bytes.size());
+    }
+
+    std::string SerializeAsString() const { return Encoded(); }
+
+    long UseCount() const noexcept { return _state.use_count(); }
+
+private:
+    struct State
+    {
+        explicit State(T v) : value(std::move(v)) {}
+
+        const T value;
+        mutable std::once_flag encodeOnce;
+        mutable std::string bytes;
+    };
+
+    const std::string& Encoded() const
+    {
+        std::call_once(_state->encodeOnce, [this]()
+        {
+            _state->bytes.reserve(Reflection::SerializedStructSize(_state->value));
+            Reflection::SerializeStruct(_state->value, _state->bytes);
+        });
+
+        return _state->bytes;
+    }
+
+    std::shared_ptr<const State> _state;
+};
+
+template<typename T>
+Frozen<std::decay_t<T>> MakeFrozen(T&& value)
+{
+    return Frozen<std::decay_t<T>>(std::forward<T>(value));
+}
+
 } // namespace ProtobufLight
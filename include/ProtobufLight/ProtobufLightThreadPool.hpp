@@ -0,0 +1,330 @@
+/* Copyright (c) 2025 Nemiritngas
+ * All rights reserved.
+ *
+ * Permission is granted to use, copy, and modify this software for personal or educational purposes only.
+ * Commercial use, including but not limited to selling, licensing, or incorporating this software into a
+ * commercial product, is strictly prohibited without the prior written consent of the author.
+ *
+ * THIS SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+
+#pragma once
+
+namespace ProtobufLight {
+
+// Executors used by the parallel APIs only need a Submit(task) method taking a void() callable,
+// Concurrency() is optional and caps the number of helper tasks.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        _threads.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i)
+            _threads.emplace_back([this]() { WorkerLoop(); });
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+            thread.join();
+    }
+
+    void Submit(std::function<void()> task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _tasks.emplace_back(std::move(task));
+        }
+        _condition.notify_one();
+    }
+
+    size_t Concurrency() const noexcept { return _threads.size(); }
+
+private:
+    void WorkerLoop()
+    {
+        for (;;)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [this]() { return _stopping || !_tasks.empty(); });
+                if (_tasks.empty())
+                    return;
+
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+};
+
+// Executor with one task queue per worker. A task submitted from a worker goes to that worker queue,
+// other submissions are spread round robin. Workers run their own newest task first and, once their
+// queue is empty, steal the oldest task of another queue, so a worker stuck on a long task doesn't
+// hold back the tasks queued behind it.
+class WorkStealingThreadPool
+{
+public:
+    explicit WorkStealingThreadPool(size_t threadCount = std::max(1u, std::thread::hardware_concurrency())) :
+        _queues(std::max<size_t>(threadCount, 1))
+    {
+        _threads.reserve(_queues.size());
+        for (size_t i = 0; i < _queues.size(); ++i)
+            _threads.emplace_back([this, i]() { WorkerLoop(i); });
+    }
+
+    WorkStealingThreadPool(const WorkStealingThreadPool&) = delete;
+    WorkStealingThreadPool& operator=(const WorkStealingThreadPool&) = delete;
+
+    ~WorkStealingThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+            thread.join();
+    }
+
+    void Submit(std::function<void()> task)
+    {
+        const WorkerSlot& worker = CurrentWorker();
+        const size_t index = worker.pool == this ? worker.index : _nextQueue.fetch_add(1, std::memory_order_relaxed) % _queues.size();
+
+        // Counted before it is queued, so a worker popping it never sees the count go below zero
+        _pending.fetch_add(1);
+        {
+            std::lock_guard<std::mutex> lock(_queues[index].mutex);
+            _queues[index].tasks.emplace_back(std::move(task));
+        }
+
+        // Taking the lock orders the new task before a worker that is about to wait checks for it
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+        }
+        _condition.notify_one();
+    }
+
+    size_t Concurrency() const noexcept { return _threads.size(); }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct WorkerSlot
+    {
+        const WorkStealingThreadPool* pool = nullptr;
+        size_t index = 0;
+    };
+
+    static WorkerSlot& CurrentWorker()
+    {
+        thread_local WorkerSlot worker;
+        return worker;
+    }
+
+    bool TryPop(size_t index, std::function<void()>& task)
+    {
+        for (size_t i = 0; i < _queues.size(); ++i)
+        {
+            Queue& queue = _queues[(index + i) % _queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty())
+                continue;
+
+            // Newest task of the own queue, its data is still in cache. Oldest task of the others.
+            if (i == 0)
+            {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+            }
+            else
+            {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+            }
+
+            _pending.fetch_sub(1);
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t index)
+    {
+        CurrentWorker() = WorkerSlot{ this, index };
+        for (;;)
+        {
+            std::function<void()> task;
+            if (TryPop(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [this]() { return _stopping || _pending.load() != 0; });
+            if (_stopping && _pending.load() == 0)
+                return;
+        }
+    }
+
+    std::vector<Queue> _queues;
+    std::vector<std::thread> _threads;
+    std::atomic<size_t> _nextQueue{ 0 };
+    std::atomic<size_t> _pending{ 0 };
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _stopping = false;
+};
+
+namespace Detail {
+
+    template<typename, typename = void>
+    struct has_concurrency_method : std::false_type {};
+
+    template<typename E>
+    struct has_concurrency_method<E, std::void_t<decltype(std::declval<const E&>().Concurrency())>> : std::true_type {};
+
+    // Anything with Submit(std::function<void()>), like ThreadPool
+    template<typename, typename = void>
+    struct is_executor : std::false_type {};
+
+    template<typename E>
+    struct is_executor<E, std::void_t<decltype(std::declval<E&>().Submit(std::declval<std::function<void()>>()))>> : std::true_type {};
+
+    template<typename E>
+    constexpr bool is_executor_v = is_executor<E>::value;
+
+    template<typename Executor>
+    size_t ExecutorConcurrency(const Executor& executor)
+    {
+        if constexpr (has_concurrency_method<Executor>::value)
+            return std::max<size_t>(1, executor.Concurrency());
+        else
+            return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+} // namespace Detail
+
+// Calls fn(begin, end) over [0, count) split in chunks of grainSize items. The calling thread takes
+// chunks too and only waits for chunks already running on the executor, so calling ParallelFor from
+// inside an executor task can't deadlock. The first exception thrown by fn is rethrown here.
+template<typename Executor, typename Fn>
+void ParallelFor(Executor& executor, size_t count, size_t grainSize, Fn&& fn)
+{
+    if (count == 0)
+        return;
+
+    grainSize = std::max<size_t>(grainSize, 1);
+    const size_t chunkCount = (count + grainSize - 1) / grainSize;
+    if (chunkCount == 1)
+    {
+        fn(size_t(0), count);
+        return;
+    }
+
+    struct State
+    {
+        std::remove_reference_t<Fn>* fn;
+        size_t count;
+        size_t grainSize;
+        size_t chunkCount;
+        std::atomic<size_t> nextChunk{ 0 };
+        std::atomic<size_t> doneChunks{ 0 };
+        std::atomic<bool> failed{ false };
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        void RunChunks()
+        {
+            for (;;)
+            {
+                const size_t chunk = nextChunk.fetch_add(1);
+                if (chunk >= chunkCount)
+                    return;
+
+                if (!failed.load(std::memory_order_relaxed))
+                {
+                    const size_t begin = chunk * grainSize;
+                    try
+                    {
+                        (*fn)(begin, std::min(begin + grainSize, count));
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error)
+                            error = std::current_exception();
+
+                        failed = true;
+                    }
+                }
+
+                if (doneChunks.fetch_add(1) + 1 == chunkCount)
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    condition.notify_all();
+                }
+            }
+        }
+    };
+
+    auto state = std::make_shared<State>();
+    state->fn = &fn;
+    state->count = count;
+    state->grainSize = grainSize;
+    state->chunkCount = chunkCount;
+
+    // Helpers that start after every chunk was taken only touch the shared state and leave.
+    const size_t helperCount = std::min(chunkCount - 1, Detail::ExecutorConcurrency(executor));
+    for (size_t i = 0; i < helperCount; ++i)
+        executor.Submit([state]() { state->RunChunks(); });
+
+    state->RunChunks();
+
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->condition.wait(lock, [&]() { return state->doneChunks.load() == chunkCount; });
+    }
+
+    if (state->error)
+        std::rethrow_exception(state->error);
+}
+
+} // namespace ProtobufLight
@@ -0,0 +1,193 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+#include <memory_resource>
+
+struct ArenaItemLight
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    int32_t id{};
+    std::pmr::string name{};
+
+    ArenaItemLight() = default;
+    explicit ArenaItemLight(const allocator_type& alloc) : name(alloc) {}
+    ArenaItemLight(const ArenaItemLight& other, const allocator_type& alloc) : id(other.id), name(other.name, alloc) {}
+    ArenaItemLight(ArenaItemLight&& other, const allocator_type& alloc) : id(std::move(other.id)), name(std::move(other.name), alloc) {}
+    ArenaItemLight(const ArenaItemLight&) = default;
+    ArenaItemLight(ArenaItemLight&&) = default;
+    ArenaItemLight& operator=(const ArenaItemLight&) = default;
+    ArenaItemLight& operator=(ArenaItemLight&&) = default;
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ArenaWrapperLight
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    ArenaItemLight single{};
+    std::pmr::vector<ArenaItemLight> many{};
+
+    ArenaWrapperLight() = default;
+    explicit ArenaWrapperLight(const allocator_type& alloc) : single(alloc), many(alloc) {}
+    ArenaWrapperLight(const ArenaWrapperLight& other, const allocator_type& alloc) : single(other.single, alloc), many(other.many, alloc) {}
+    ArenaWrapperLight(ArenaWrapperLight&& other, const allocator_type& alloc) : single(std::move(other.single), alloc), many(std::move(other.many), alloc) {}
+    ArenaWrapperLight(const ArenaWrapperLight&) = default;
+    ArenaWrapperLight(ArenaWrapperLight&&) = default;
+    ArenaWrapperLight& operator=(const ArenaWrapperLight&) = default;
+    ArenaWrapperLight& operator=(ArenaWrapperLight&&) = default;
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ArenaRepeatedMessagesLight
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::vector<ArenaItemLight> items{};
+    std::pmr::vector<ArenaWrapperLight> wrappers{};
+
+    ArenaRepeatedMessagesLight() = default;
+    explicit ArenaRepeatedMessagesLight(const allocator_type& alloc) : items(alloc), wrappers(alloc) {}
+    ArenaRepeatedMessagesLight(const ArenaRepeatedMessagesLight& other, const allocator_type& alloc) : items(other.items, alloc), wrappers(other.wrappers, alloc) {}
+    ArenaRepeatedMessagesLight(ArenaRepeatedMessagesLight&& other, const allocator_type& alloc) : items(std::move(other.items), alloc), wrappers(std::move(other.wrappers), alloc) {}
+    ArenaRepeatedMessagesLight(const ArenaRepeatedMessagesLight&) = default;
+    ArenaRepeatedMessagesLight(ArenaRepeatedMessagesLight&&) = default;
+    ArenaRepeatedMessagesLight& operator=(const ArenaRepeatedMessagesLight&) = default;
+    ArenaRepeatedMessagesLight& operator=(ArenaRepeatedMessagesLight&&) = default;
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ArenaValLight
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    int32_t a{};
+    std::pmr::string b{};
+
+    ArenaValLight() = default;
+    explicit ArenaValLight(const allocator_type& alloc) : b(alloc) {}
+    ArenaValLight(const ArenaValLight& other, const allocator_type& alloc) : a(other.a), b(other.b, alloc) {}
+    ArenaValLight(ArenaValLight&& other, const allocator_type& alloc) : a(std::move(other.a)), b(std::move(other.b), alloc) {}
+    ArenaValLight(const ArenaValLight&) = default;
+    ArenaValLight(ArenaValLight&&) = default;
+    ArenaValLight& operator=(const ArenaValLight&) = default;
+    ArenaValLight& operator=(ArenaValLight&&) = default;
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ArenaInnerValLight
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    ArenaValLight v{};
+
+    ArenaInnerValLight() = default;
+    explicit ArenaInnerValLight(const allocator_type& alloc) : v(alloc) {}
+    ArenaInnerValLight(const ArenaInnerValLight& other, const allocator_type& alloc) : v(other.v, alloc) {}
+    ArenaInnerValLight(ArenaInnerValLight&& other, const allocator_type& alloc) : v(std::move(other.v), alloc) {}
+    ArenaInnerValLight(const ArenaInnerValLight&) = default;
+    ArenaInnerValLight(ArenaInnerValLight&&) = default;
+    ArenaInnerValLight& operator=(const ArenaInnerValLight&) = default;
+    ArenaInnerValLight& operator=(ArenaInnerValLight&&) = default;
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ArenaMapsMessagesLight
+{
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    std::pmr::map<std::pmr::string, ArenaValLight> m_str_msg{};
+    std::pmr::map<int32_t, ArenaValLight> m_i32_msg{};
+    std::pmr::map<int64_t, ArenaInnerValLight> m_i64_inner{};
+
+    ArenaMapsMessagesLight() = default;
+    explicit ArenaMapsMessagesLight(const allocator_type& alloc) : m_str_msg(alloc), m_i32_msg(alloc), m_i64_inner(alloc) {}
+    ArenaMapsMessagesLight(const ArenaMapsMessagesLight& other, const allocator_type& alloc) : m_str_msg(other.m_str_msg, alloc), m_i32_msg(other.m_i32_msg, alloc), m_i64_inner(other.m_i64_inner, alloc) {}
+    ArenaMapsMessagesLight(ArenaMapsMessagesLight&& other, const allocator_type& alloc) : m_str_msg(std::move(other.m_str_msg), alloc), m_i32_msg(std::move(other.m_i32_msg), alloc), m_i64_inner(std::move(other.m_i64_inner), alloc) {}
+    ArenaMapsMessagesLight(const ArenaMapsMessagesLight&) = default;
+    ArenaMapsMessagesLight(ArenaMapsMessagesLight&&) = default;
+    ArenaMapsMessagesLight& operator=(const ArenaMapsMessagesLight&) = default;
+    ArenaMapsMessagesLight& operator=(ArenaMapsMessagesLight&&) = default;
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ArenaItemLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.id, FieldMeta<1>{"id"});
+        cb(obj.name, FieldMeta<2>{"name"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ArenaWrapperLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.single, FieldMeta<1>{"single"});
+        cb(obj.many, FieldMeta<2>{"many"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ArenaRepeatedMessagesLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.items, FieldMeta<1>{"items"});
+        cb(obj.wrappers, FieldMeta<2>{"wrappers"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ArenaValLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.a, FieldMeta<1>{"a"});
+        cb(obj.b, FieldMeta<2>{"b"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ArenaInnerValLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.v, FieldMeta<1>{"v"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ArenaMapsMessagesLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.m_str_msg, FieldMeta<1>{"m_str_msg"});
+        cb(obj.m_i32_msg, FieldMeta<2>{"m_i32_msg"});
+        cb(obj.m_i64_inner, FieldMeta<3>{"m_i64_inner"});
+    }
+};
+
@@ -0,0 +1,47 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+enum class BoxedOneEnumLight : int32_t
+{
+    BOXED_O_ZERO = 0,
+    BOXED_O_ONE = 1,
+};
+
+struct BoxedOneMsgLight
+{
+    int32_t id{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct BoxedOneOfAllLight
+{
+    std::variant<std::monostate, int32_t, ProtobufLight::Box<std::string>, BoxedOneMsgLight, BoxedOneEnumLight> choice{ std::monostate{} };
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<BoxedOneMsgLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.id, FieldMeta<1>{"id"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<BoxedOneOfAllLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.choice, FieldMeta<1,3,4,5>{"choice"});
+    }
+};
+
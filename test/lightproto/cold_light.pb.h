@@ -0,0 +1,99 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+enum class ColdEnumLight : int32_t
+{
+    COLD_ENUM_ZERO = 0,
+    COLD_ENUM_ONE = 1,
+    COLD_ENUM_TWO = 2,
+};
+
+struct ColdScalarsLight
+{
+    struct ColdData
+    {
+        uint32_t f_uint32{};
+        uint64_t f_uint64{};
+        int32_t f_sint32{};
+        int64_t f_sint64{};
+        uint32_t f_fixed32{};
+        uint64_t f_fixed64{};
+        int32_t f_sfixed32{};
+        int64_t f_sfixed64{};
+        float f_float{};
+        double f_double{};
+        std::string f_bytes{};
+    };
+
+    int32_t f_int32{};
+    int64_t f_int64{};
+    bool f_bool{};
+    std::string f_string{};
+    ColdEnumLight f_enum{};
+    ProtobufLight::ColdFields<ColdData> _cold{};
+
+    const uint32_t& f_uint32() const { return _cold.Get().f_uint32; }
+    uint32_t& mutable_f_uint32() { return _cold.Mutable().f_uint32; }
+    void set_f_uint32(uint32_t value) { _cold.Mutable().f_uint32 = std::move(value); }
+    const uint64_t& f_uint64() const { return _cold.Get().f_uint64; }
+    uint64_t& mutable_f_uint64() { return _cold.Mutable().f_uint64; }
+    void set_f_uint64(uint64_t value) { _cold.Mutable().f_uint64 = std::move(value); }
+    const int32_t& f_sint32() const { return _cold.Get().f_sint32; }
+    int32_t& mutable_f_sint32() { return _cold.Mutable().f_sint32; }
+    void set_f_sint32(int32_t value) { _cold.Mutable().f_sint32 = std::move(value); }
+    const int64_t& f_sint64() const { return _cold.Get().f_sint64; }
+    int64_t& mutable_f_sint64() { return _cold.Mutable().f_sint64; }
+    void set_f_sint64(int64_t value) { _cold.Mutable().f_sint64 = std::move(value); }
+    const uint32_t& f_fixed32() const { return _cold.Get().f_fixed32; }
+    uint32_t& mutable_f_fixed32() { return _cold.Mutable().f_fixed32; }
+    void set_f_fixed32(uint32_t value) { _cold.Mutable().f_fixed32 = std::move(value); }
+    const uint64_t& f_fixed64() const { return _cold.Get().f_fixed64; }
+    uint64_t& mutable_f_fixed64() { return _cold.Mutable().f_fixed64; }
+    void set_f_fixed64(uint64_t value) { _cold.Mutable().f_fixed64 = std::move(value); }
+    const int32_t& f_sfixed32() const { return _cold.Get().f_sfixed32; }
+    int32_t& mutable_f_sfixed32() { return _cold.Mutable().f_sfixed32; }
+    void set_f_sfixed32(int32_t value) { _cold.Mutable().f_sfixed32 = std::move(value); }
+    const int64_t& f_sfixed64() const { return _cold.Get().f_sfixed64; }
+    int64_t& mutable_f_sfixed64() { return _cold.Mutable().f_sfixed64; }
+    void set_f_sfixed64(int64_t value) { _cold.Mutable().f_sfixed64 = std::move(value); }
+    const float& f_float() const { return _cold.Get().f_float; }
+    float& mutable_f_float() { return _cold.Mutable().f_float; }
+    void set_f_float(float value) { _cold.Mutable().f_float = std::move(value); }
+    const double& f_double() const { return _cold.Get().f_double; }
+    double& mutable_f_double() { return _cold.Mutable().f_double; }
+    void set_f_double(double value) { _cold.Mutable().f_double = std::move(value); }
+    const std::string& f_bytes() const { return _cold.Get().f_bytes; }
+    std::string& mutable_f_bytes() { return _cold.Mutable().f_bytes; }
+    void set_f_bytes(std::string value) { _cold.Mutable().f_bytes = std::move(value); }
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ColdScalarsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.f_int32, FieldMeta<1>{"f_int32"});
+        cb(obj.f_int64, FieldMeta<2>{"f_int64"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_uint32), FieldMeta<3>{"f_uint32"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_uint64), FieldMeta<4>{"f_uint64"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_sint32), FieldMeta<5>{"f_sint32"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_sint64), FieldMeta<6>{"f_sint64"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_fixed32), FieldMeta<7>{"f_fixed32"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_fixed64), FieldMeta<8>{"f_fixed64"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_sfixed32), FieldMeta<9>{"f_sfixed32"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_sfixed64), FieldMeta<10>{"f_sfixed64"});
+        cb(obj.f_bool, FieldMeta<11>{"f_bool"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_float), FieldMeta<12>{"f_float"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_double), FieldMeta<13>{"f_double"});
+        cb(obj.f_string, FieldMeta<14>{"f_string"});
+        cb(ProtobufLight::MakeColdRef(obj._cold, &ColdScalarsLight::ColdData::f_bytes), FieldMeta<15>{"f_bytes"});
+        cb(obj.f_enum, FieldMeta<16>{"f_enum"});
+    }
+};
+
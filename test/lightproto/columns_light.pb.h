@@ -0,0 +1,89 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+#include <ProtobufLight/ProtobufLightColumns.hpp>
+
+struct ColItemLight
+{
+    int32_t id{};
+    std::string name{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ColWrapperLight
+{
+    ColItemLight single{};
+    std::vector<ColItemLight> many{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ColRepeatedMessagesLight
+{
+    std::vector<ColItemLight> items{};
+    std::vector<ColWrapperLight> wrappers{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+// Struct-of-arrays ColItemLight rows, filled by ProtobufLight::Reflection::ParseColumns
+struct ColItemLightColumns
+{
+    size_t rows{};
+    std::vector<int32_t> id{};
+    ProtobufLight::BoolVector id_present{};
+    ProtobufLight::StringList name{};
+    ProtobufLight::BoolVector name_present{};
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ColItemLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.id, FieldMeta<1>{"id"});
+        cb(obj.name, FieldMeta<2>{"name"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ColWrapperLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.single, FieldMeta<1>{"single"});
+        cb(obj.many, FieldMeta<2>{"many"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ColRepeatedMessagesLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.items, FieldMeta<1>{"items"});
+        cb(obj.wrappers, FieldMeta<2>{"wrappers"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ColumnsTrait<ColItemLightColumns>
+{
+    using Row = ColItemLight;
+
+    template<typename Obj, typename Callback>
+    static void ForEachColumn(Obj& obj, Callback&& cb) {
+        cb(obj.id, obj.id_present, FieldMeta<1>{"id"});
+        cb(obj.name, obj.name_present, FieldMeta<2>{"name"});
+    }
+};
+
@@ -10,8 +10,8 @@ struct CompatV2Light
     int64_t c{};
     std::string d{};
 
-    size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-    bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
     std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
 };
 
@@ -19,7 +19,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<CompatV2Light>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.a, FieldMeta<1>{"a"});
         cb(obj.b, FieldMeta<2>{"b"});
         cb(obj.c, FieldMeta<1001>{"c"});
@@ -0,0 +1,64 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+enum class ConstexprEnumLight : int32_t
+{
+    C_ZERO = 0,
+    C_ONE = 1,
+    C_TWO = 2,
+};
+
+struct ConstexprInnerLight
+{
+    int32_t i{};
+    double d{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ConstexprLight
+{
+    int32_t i32{};
+    uint64_t u64{};
+    bool b{};
+    float f{};
+    ConstexprEnumLight e{};
+    std::optional<int32_t> o{};
+    ConstexprInnerLight inner{};
+    int64_t far{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ConstexprInnerLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.i, FieldMeta<1>{"i"});
+        cb(obj.d, FieldMeta<2>{"d"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ConstexprLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.i32, FieldMeta<1>{"i32"});
+        cb(obj.u64, FieldMeta<2>{"u64"});
+        cb(obj.b, FieldMeta<3>{"b"});
+        cb(obj.f, FieldMeta<4>{"f"});
+        cb(obj.e, FieldMeta<5>{"e"});
+        cb(obj.o, FieldMeta<6>{"o"});
+        cb(obj.inner, FieldMeta<7>{"inner"});
+        cb(obj.far, FieldMeta<100>{"far"});
+    }
+};
+
@@ -11,8 +11,8 @@ struct DefaultsLight
     std::string by{};
     double d{};
 
-    size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-    bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
     std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
 };
 
@@ -20,7 +20,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<DefaultsLight>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.i32, FieldMeta<1>{"i32"});
         cb(obj.b, FieldMeta<2>{"b"});
         cb(obj.s, FieldMeta<3>{"s"});
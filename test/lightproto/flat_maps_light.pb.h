@@ -0,0 +1,65 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+struct FlatValLight
+{
+    int32_t a{};
+    std::string b{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct FlatInnerValLight
+{
+    FlatValLight v{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct FlatMapsMessagesLight
+{
+    ProtobufLight::FlatMap<std::string, FlatValLight> m_str_msg{};
+    ProtobufLight::FlatMap<int32_t, FlatValLight> m_i32_msg{};
+    ProtobufLight::FlatMap<int64_t, FlatInnerValLight> m_i64_inner{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<FlatValLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.a, FieldMeta<1>{"a"});
+        cb(obj.b, FieldMeta<2>{"b"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<FlatInnerValLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.v, FieldMeta<1>{"v"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<FlatMapsMessagesLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.m_str_msg, FieldMeta<1>{"m_str_msg"});
+        cb(obj.m_i32_msg, FieldMeta<2>{"m_i32_msg"});
+        cb(obj.m_i64_inner, FieldMeta<3>{"m_i64_inner"});
+    }
+};
+
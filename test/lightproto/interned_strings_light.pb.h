@@ -0,0 +1,63 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+struct InternScalarsLight
+{
+    ProtobufLight::InternedString f_string{};
+    std::string f_bytes{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct InternRepeatedLight
+{
+    std::vector<ProtobufLight::InternedString> r_strings{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct InternMapsLight
+{
+    std::map<ProtobufLight::InternedString, int32_t> m_str_i32{};
+    std::map<int32_t, std::string> m_i32_str{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<InternScalarsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.f_string, FieldMeta<14>{"f_string"});
+        cb(obj.f_bytes, FieldMeta<15>{"f_bytes"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<InternRepeatedLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.r_strings, FieldMeta<6>{"r_strings"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<InternMapsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.m_str_i32, FieldMeta<1>{"m_str_i32"});
+        cb(obj.m_i32_str, FieldMeta<2>{"m_i32_str"});
+    }
+};
+
@@ -10,8 +10,8 @@ struct MapsScalarsLight
     std::map<int64_t, uint64_t> m_i64_u64{};
     std::map<uint32_t, int32_t> m_u32_s32{};
 
-    size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-    bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
     std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
 };
 
@@ -19,7 +19,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<MapsScalarsLight>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.m_str_i32, FieldMeta<1>{"m_str_i32"});
         cb(obj.m_i32_str, FieldMeta<2>{"m_i32_str"});
         cb(obj.m_i64_u64, FieldMeta<3>{"m_i64_u64"});
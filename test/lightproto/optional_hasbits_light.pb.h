@@ -0,0 +1,78 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+enum class OptHasbitsEnumLight : int32_t
+{
+    OPT_HASBITS_ZERO = 0,
+    OPT_HASBITS_ONE = 1,
+};
+
+struct OptionalHasbitsLight
+{
+    struct HasbitsInnerLight
+    {
+        int32_t x{};
+
+        constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+        constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+        std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+    };
+
+    int32_t o_int32{};
+    std::string o_string{};
+    OptHasbitsEnumLight o_enum{};
+    HasbitsInnerLight msg{};
+    ProtobufLight::HasBits<3> _has_bits{};
+
+    bool has_o_int32() const { return _has_bits.Test(0); }
+    void set_o_int32(int32_t value) { o_int32 = std::move(value); _has_bits.Set(0); }
+    void clear_o_int32() { o_int32 = {}; _has_bits.Reset(0); }
+    bool has_o_string() const { return _has_bits.Test(1); }
+    void set_o_string(std::string value) { o_string = std::move(value); _has_bits.Set(1); }
+    void clear_o_string() { o_string = {}; _has_bits.Reset(1); }
+    bool has_o_enum() const { return _has_bits.Test(2); }
+    void set_o_enum(OptHasbitsEnumLight value) { o_enum = std::move(value); _has_bits.Set(2); }
+    void clear_o_enum() { o_enum = {}; _has_bits.Reset(2); }
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<OptionalHasbitsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(ProtobufLight::MakeHasBitRef(obj.o_int32, obj._has_bits, 0), FieldMeta<1>{"o_int32"});
+        cb(ProtobufLight::MakeHasBitRef(obj.o_string, obj._has_bits, 1), FieldMeta<2>{"o_string"});
+        cb(ProtobufLight::MakeHasBitRef(obj.o_enum, obj._has_bits, 2), FieldMeta<3>{"o_enum"});
+        cb(obj.msg, FieldMeta<10>{"msg"});
+    }
+
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachPresentField(Obj& obj, Callback&& cb) {
+        for (uint32_t bits = obj._has_bits.Word(0) & 0x7u; bits != 0; bits &= bits - 1)
+        {
+            switch (ProtobufLight::CountTrailingZeros(bits))
+            {
+                case 0: cb(ProtobufLight::MakeHasBitRef(obj.o_int32, obj._has_bits, 0), FieldMeta<1>{"o_int32"}); break;
+                case 1: cb(ProtobufLight::MakeHasBitRef(obj.o_string, obj._has_bits, 1), FieldMeta<2>{"o_string"}); break;
+                case 2: cb(ProtobufLight::MakeHasBitRef(obj.o_enum, obj._has_bits, 2), FieldMeta<3>{"o_enum"}); break;
+            }
+        }
+        cb(obj.msg, FieldMeta<10>{"msg"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<OptionalHasbitsLight::HasbitsInnerLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.x, FieldMeta<1>{"x"});
+    }
+};
+
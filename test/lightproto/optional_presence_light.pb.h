@@ -15,8 +15,8 @@ struct OptionalPresenceLight
     {
         int32_t x{};
 
-        size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-        bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+        constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+        constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
         std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
     };
 
@@ -25,8 +25,8 @@ struct OptionalPresenceLight
     std::optional<OptEnumLight> o_enum{};
     HasPresenceLight msg{};
 
-    size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-    bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
     std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
 };
 
@@ -34,7 +34,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<OptionalPresenceLight>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.o_int32, FieldMeta<1>{"o_int32"});
         cb(obj.o_string, FieldMeta<2>{"o_string"});
         cb(obj.o_enum, FieldMeta<3>{"o_enum"});
@@ -46,7 +46,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<OptionalPresenceLight::HasPresenceLight>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.x, FieldMeta<1>{"x"});
     }
 };
@@ -0,0 +1,52 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+struct PackedBoolsLight
+{
+    int32_t i32{};
+    std::string s{};
+    std::string by{};
+    double d{};
+    ProtobufLight::BoolBits<1> _bool_bits{};
+
+    bool b() const { return _bool_bits.Test(0); }
+    void set_b(bool value) { _bool_bits.Assign(0, value); }
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct PackedRepeatedBoolsLight
+{
+    ProtobufLight::BoolVector r_int32_default_packed{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<PackedBoolsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.i32, FieldMeta<1>{"i32"});
+        cb(ProtobufLight::MakeBoolRef(obj._bool_bits, 0), FieldMeta<2>{"b"});
+        cb(obj.s, FieldMeta<3>{"s"});
+        cb(obj.by, FieldMeta<4>{"by"});
+        cb(obj.d, FieldMeta<5>{"d"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<PackedRepeatedBoolsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.r_int32_default_packed, FieldMeta<1>{"r_int32_default_packed"});
+    }
+};
+
@@ -3,4 +3,18 @@
 for %%f in (*_light.proto) do (
     python ../../bin/protobuflight_protoc.py "%%f" "%%~nf.pb.h"
 )
+
+python ../../bin/protobuflight_protoc.py --pmr "arena_light.proto" "arena_light.pb.h"
+python ../../bin/protobuflight_protoc.py --presence=hasbits "optional_hasbits_light.proto" "optional_hasbits_light.pb.h"
+python ../../bin/protobuflight_protoc.py --layout=packed --layout-report "layout_light.proto" "layout_light.pb.h"
+python ../../bin/protobuflight_protoc.py --cold-fields "cold_light.cold" "cold_light.proto" "cold_light.pb.h"
+python ../../bin/protobuflight_protoc.py --narrow-enums "narrow_enums_light.proto" "narrow_enums_light.pb.h"
+python ../../bin/protobuflight_protoc.py --pack-bools "packed_bools_light.proto" "packed_bools_light.pb.h"
+python ../../bin/protobuflight_protoc.py --box-threshold=16 --layout-report "boxed_oneof_light.proto" "boxed_oneof_light.pb.h"
+python ../../bin/protobuflight_protoc.py --map=flat "flat_maps_light.proto" "flat_maps_light.pb.h"
+python ../../bin/protobuflight_protoc.py --map=hash "hash_maps_light.proto" "hash_maps_light.pb.h"
+python ../../bin/protobuflight_protoc.py --shared-bytes "shared_bytes_light.proto" "shared_bytes_light.pb.h"
+python ../../bin/protobuflight_protoc.py --compact-strings "string_list_light.proto" "string_list_light.pb.h"
+python ../../bin/protobuflight_protoc.py --small-vector=4 "small_vector_light.proto" "small_vector_light.pb.h"
+python ../../bin/protobuflight_protoc.py --columns ColItemLight "columns_light.proto" "columns_light.pb.h"
 pause
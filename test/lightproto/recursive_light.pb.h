@@ -0,0 +1,69 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+struct TreeLight;
+struct ExprLight;
+struct BinaryLight;
+
+struct TreeLight
+{
+    ProtobufLight::NodePtr<TreeLight> child{};
+    std::vector<TreeLight> children{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct ExprLight
+{
+    std::variant<std::monostate, int64_t, ProtobufLight::NodePtr<BinaryLight>> node{ std::monostate{} };
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct BinaryLight
+{
+    ProtobufLight::NodePtr<ExprLight> lhs{};
+    ProtobufLight::NodePtr<ExprLight> rhs{};
+    std::map<std::string, ProtobufLight::NodePtr<ExprLight>> bindings{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<TreeLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.child, FieldMeta<1>{"child"});
+        cb(obj.children, FieldMeta<2>{"children"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<ExprLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.node, FieldMeta<1,2>{"node"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<BinaryLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.lhs, FieldMeta<1>{"lhs"});
+        cb(obj.rhs, FieldMeta<2>{"rhs"});
+        cb(obj.bindings, FieldMeta<3>{"bindings"});
+    }
+};
+
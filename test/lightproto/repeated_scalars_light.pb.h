@@ -20,8 +20,8 @@ struct RepeatedScalarsLight
     std::vector<std::string> r_strings{};
     std::vector<std::string> r_bytes{};
 
-    size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-    bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
     std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
 };
 
@@ -29,7 +29,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<RepeatedScalarsLight>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.r_int32_default_packed, FieldMeta<1>{"r_int32_default_packed"});
         cb(obj.r_sint32_unpacked, FieldMeta<2>{"r_sint32_unpacked"});
         cb(obj.r_fixed32_packed, FieldMeta<3>{"r_fixed32_packed"});
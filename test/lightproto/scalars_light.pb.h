@@ -29,8 +29,8 @@ struct ScalarsLight
     std::string f_bytes{};
     TestEnumLight f_enum{};
 
-    size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
-    bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
     std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
 };
 
@@ -38,7 +38,7 @@ template<>
 struct ProtobufLight::Reflection::ProtobufTrait<ScalarsLight>
 {
     template<typename Obj, typename Callback>
-    static void ForEachField(Obj& obj, Callback&& cb) {
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
         cb(obj.f_int32, FieldMeta<1>{"f_int32"});
         cb(obj.f_int64, FieldMeta<2>{"f_int64"});
         cb(obj.f_uint32, FieldMeta<3>{"f_uint32"});
@@ -0,0 +1,45 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+struct SharedScalarsLight
+{
+    std::string f_string{};
+    ProtobufLight::SharedBytes f_bytes{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct SharedRepeatedLight
+{
+    std::vector<std::string> r_strings{};
+    std::vector<ProtobufLight::SharedBytes> r_bytes{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<SharedScalarsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.f_string, FieldMeta<14>{"f_string"});
+        cb(obj.f_bytes, FieldMeta<15>{"f_bytes"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<SharedRepeatedLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.r_strings, FieldMeta<6>{"r_strings"});
+        cb(obj.r_bytes, FieldMeta<7>{"r_bytes"});
+    }
+};
+
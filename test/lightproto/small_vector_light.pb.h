@@ -0,0 +1,102 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+enum class SmallEnumLight : int32_t
+{
+    S_ZERO = 0,
+    S_ONE = 1,
+    S_TWO = 2,
+};
+
+struct SmallScalarsLight
+{
+    ProtobufLight::SmallVector<int32_t, 4> r_int32_default_packed{};
+    ProtobufLight::SmallVector<int32_t, 4> r_sint32_unpacked{};
+    ProtobufLight::SmallVector<uint32_t, 4> r_fixed32_packed{};
+    ProtobufLight::SmallVector<double, 4> r_double_unpacked{};
+    ProtobufLight::SmallVector<SmallEnumLight, 4> r_enums_default_packed{};
+    ProtobufLight::SmallVector<std::string, 4> r_strings{};
+    ProtobufLight::SmallVector<std::string, 4> r_bytes{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct SmallItemLight
+{
+    int32_t id{};
+    std::string name{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct SmallWrapperLight
+{
+    SmallItemLight single{};
+    ProtobufLight::SmallVector<SmallItemLight, 2> many{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+struct SmallMessagesLight
+{
+    ProtobufLight::SmallVector<SmallItemLight, 2> items{};
+    std::vector<SmallWrapperLight> wrappers{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<SmallScalarsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.r_int32_default_packed, FieldMeta<1>{"r_int32_default_packed"});
+        cb(obj.r_sint32_unpacked, FieldMeta<2>{"r_sint32_unpacked"});
+        cb(obj.r_fixed32_packed, FieldMeta<3>{"r_fixed32_packed"});
+        cb(obj.r_double_unpacked, FieldMeta<4>{"r_double_unpacked"});
+        cb(obj.r_enums_default_packed, FieldMeta<5>{"r_enums_default_packed"});
+        cb(obj.r_strings, FieldMeta<6>{"r_strings"});
+        cb(obj.r_bytes, FieldMeta<7>{"r_bytes"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<SmallItemLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.id, FieldMeta<1>{"id"});
+        cb(obj.name, FieldMeta<2>{"name"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<SmallWrapperLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.single, FieldMeta<1>{"single"});
+        cb(obj.many, FieldMeta<2>{"many"});
+    }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<SmallMessagesLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.items, FieldMeta<1>{"items"});
+        cb(obj.wrappers, FieldMeta<2>{"wrappers"});
+    }
+};
+
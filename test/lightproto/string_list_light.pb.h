@@ -0,0 +1,42 @@
+// Auto-generated from .proto
+#pragma once
+
+#include <ProtobufLight/ProtobufLightReflection.hpp>
+
+enum class ListEnumLight : int32_t
+{
+    L_ZERO = 0,
+    L_ONE = 1,
+    L_TWO = 2,
+};
+
+struct StringListScalarsLight
+{
+    std::vector<int32_t> r_int32_default_packed{};
+    std::vector<int32_t> r_sint32_unpacked{};
+    std::vector<uint32_t> r_fixed32_packed{};
+    std::vector<double> r_double_unpacked{};
+    std::vector<ListEnumLight> r_enums_default_packed{};
+    ProtobufLight::StringList r_strings{};
+    ProtobufLight::StringList r_bytes{};
+
+    constexpr size_t GetByteSize() const { return ProtobufLight::Reflection::SerializedStructSize(*this); }
+    constexpr bool ParseFromArray(const uint8_t* buffer, size_t size) { return ProtobufLight::Reflection::ParseStruct(*this, buffer, size); }
+    std::string SerializeAsString() const { std::string out; ProtobufLight::Reflection::SerializeStruct(*this, out); return out; }
+};
+
+template<>
+struct ProtobufLight::Reflection::ProtobufTrait<StringListScalarsLight>
+{
+    template<typename Obj, typename Callback>
+    static constexpr void ForEachField(Obj& obj, Callback&& cb) {
+        cb(obj.r_int32_default_packed, FieldMeta<1>{"r_int32_default_packed"});
+        cb(obj.r_sint32_unpacked, FieldMeta<2>{"r_sint32_unpacked"});
+        cb(obj.r_fixed32_packed, FieldMeta<3>{"r_fixed32_packed"});
+        cb(obj.r_double_unpacked, FieldMeta<4>{"r_double_unpacked"});
+        cb(obj.r_enums_default_packed, FieldMeta<5>{"r_enums_default_packed"});
+        cb(obj.r_strings, FieldMeta<6>{"r_strings"});
+        cb(obj.r_bytes, FieldMeta<7>{"r_bytes"});
+    }
+};
+
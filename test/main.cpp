@@ -2,6 +2,8 @@
 #include "catch.hpp"
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <thread>
 
 #include "proto/scalars.pb.h"
 #include "proto/repeated_scalars.pb.h"
@@ -26,6 +28,26 @@
 #include "lightproto/defaults_light.pb.h"
 #include "lightproto/compat_v1_light.pb.h"
 #include "lightproto/compat_v2_light.pb.h"
+#include "lightproto/constexpr_light.pb.h"
+#include "lightproto/arena_light.pb.h"
+#include "lightproto/optional_hasbits_light.pb.h"
+#include "lightproto/layout_light.pb.h"
+#include "lightproto/cold_light.pb.h"
+#include "lightproto/narrow_enums_light.pb.h"
+#include "lightproto/packed_bools_light.pb.h"
+#include "lightproto/boxed_oneof_light.pb.h"
+#include "lightproto/flat_maps_light.pb.h"
+#include "lightproto/hash_maps_light.pb.h"
+#include "lightproto/shared_bytes_light.pb.h"
+#include "lightproto/string_list_light.pb.h"
+#include "lightproto/interned_strings_light.pb.h"
+#include "lightproto/small_vector_light.pb.h"
+#include "lightproto/recursive_light.pb.h"
+#include "lightproto/columns_light.pb.h"
+
+#include <ProtobufLight/ProtobufLightBufferPool.hpp>
+#include <ProtobufLight/ProtobufLightMessagePool.hpp>
+#include <ProtobufLight/ProtobufLightParallel.hpp>
 
 using namespace std;
 
@@ -194,3 +216,1144 @@ TEST_CASE("Compat V1 vs V2") {
 
     roundtrip(g2, l2);
 }
+
+TEST_CASE("Constexpr") {
+    using namespace ProtobufLight::Reflection;
+
+    static constexpr LeafLight kLeaf{ 123 };
+    static constexpr auto kLeafBytes = SerializeToArray<SerializedStructSize(kLeaf)>(kLeaf);
+
+    Leaf g;
+    g.set_id(123);
+    REQUIRE(compareBuffers(g.SerializeAsString(), std::string(kLeafBytes.begin(), kLeafBytes.end())));
+
+    static constexpr ConstexprLight kMsg = [] {
+        ConstexprLight m{};
+        m.i32 = -5;
+        m.u64 = 1ull << 40;
+        m.b = true;
+        m.f = 1.5f;
+        m.e = ConstexprEnumLight::C_TWO;
+        m.o = 0;
+        m.inner.i = 7;
+        m.inner.d = -0.25;
+        m.far = 300;
+        return m;
+    }();
+    static constexpr auto kBytes = SerializeToArray<kMsg.GetByteSize()>(kMsg);
+
+    constexpr ConstexprLight kParsed = [] {
+        ConstexprLight m{};
+        m.ParseFromArray(kBytes.data(), kBytes.size());
+        return m;
+    }();
+    static_assert(kParsed.i32 == -5 && kParsed.u64 == (1ull << 40) && kParsed.b && kParsed.f == 1.5f, "Constexpr parse failed");
+    static_assert(kParsed.e == ConstexprEnumLight::C_TWO && kParsed.o == 0 && kParsed.far == 300, "Constexpr parse failed");
+    static_assert(kParsed.inner.i == 7 && kParsed.inner.d == -0.25, "Constexpr parse failed");
+
+    REQUIRE(compareBuffers(kMsg.SerializeAsString(), std::string(kBytes.begin(), kBytes.end())));
+
+    // Too small an array throws before anything is written past it
+    REQUIRE_THROWS_AS(SerializeToArray<4>(kMsg), std::length_error);
+}
+
+TEST_CASE("Max serialized size") {
+    using namespace ProtobufLight::Reflection;
+
+    static_assert(MaxSerializedSize_v<LeafLight> == 11u, "Leaf is key + 10 bytes varint");
+    static_assert(MaxSerializedSize_v<ConstexprInnerLight> == 20u, "Wrong max size");
+    static_assert(MaxSerializedSize_v<ConstexprLight> == 85u, "Wrong max size");
+    static_assert(!MaxSerializedSize_v<ItemLight>.has_value(), "Strings are unbounded");
+    static_assert(!MaxSerializedSize_v<NestedAllLight>.has_value(), "Repeated fields are unbounded");
+    static_assert(!MaxSerializedSize_v<OneOfAllLight>.has_value(), "Oneof with bytes is unbounded");
+
+    ConstexprLight l;
+    l.i32 = std::numeric_limits<int32_t>::min();
+    l.u64 = std::numeric_limits<uint64_t>::max();
+    l.b = true;
+    l.f = -1.0f;
+    l.e = static_cast<ConstexprEnumLight>(-1);
+    l.o = -1;
+    l.inner.i = -1;
+    l.inner.d = 2.0;
+    l.far = -1;
+
+    auto buffer = SerializeToStaticBuffer(l);
+    // The capacity is the proven bound, appending skips the overflow checks
+    static_assert(std::is_same_v<decltype(buffer), ProtobufLight::StaticBuffer<*MaxSerializedSize_v<ConstexprLight>, false>>);
+    REQUIRE(buffer.size() == l.GetByteSize());
+    REQUIRE(buffer.size() == *MaxSerializedSize_v<ConstexprLight>);
+    REQUIRE(compareBuffers(l.SerializeAsString(), std::string(buffer.begin(), buffer.end())));
+
+    Leaf g;
+    g.set_id(-42);
+    LeafLight leaf;
+    leaf.id = -42;
+    auto leafBuffer = SerializeToStaticBuffer(leaf);
+    REQUIRE(compareBuffers(g.SerializeAsString(), std::string(leafBuffer.begin(), leafBuffer.end())));
+}
+
+TEST_CASE("Pooled serialization") {
+    ScalarsLight l;
+    l.f_int32 = 42;
+    l.f_string = std::string(200, 'x');
+    l.f_enum = TestEnumLight::ENUM_TWO;
+
+    const uint8_t* firstData = nullptr;
+    {
+        auto buffer = ProtobufLight::Reflection::SerializePooled(l);
+        REQUIRE(compareBuffers(l.SerializeAsString(), buffer.str()));
+        firstData = buffer.data();
+    }
+    REQUIRE(ProtobufLight::BufferPool::ThreadLocal().PooledBuffers() == 1);
+
+    // The released buffer is reused with its capacity
+    auto buffer = ProtobufLight::Reflection::SerializePooled(l);
+    REQUIRE(buffer.data() == firstData);
+    REQUIRE(compareBuffers(l.SerializeAsString(), buffer.str()));
+    REQUIRE(ProtobufLight::BufferPool::ThreadLocal().PooledBuffers() == 0);
+
+    auto moved = std::move(buffer);
+    buffer.Release();
+    REQUIRE(ProtobufLight::BufferPool::ThreadLocal().PooledBuffers() == 0);
+
+    // A handle outliving its thread pool at thread exit frees its buffer instead of touching the dead pool
+    size_t lateSize = 0;
+    std::thread([&l, &lateSize]()
+    {
+        thread_local ProtobufLight::PooledBuffer lateBuffer;
+        lateBuffer = ProtobufLight::Reflection::SerializePooled(l);
+        lateSize = lateBuffer.size();
+    }).join();
+    REQUIRE(lateSize == l.GetByteSize());
+    moved.Release();
+    REQUIRE(ProtobufLight::BufferPool::ThreadLocal().PooledBuffers() == 1);
+}
+
+TEST_CASE("Parallel serialization") {
+    RepeatedMessages g;
+    RepeatedMessagesLight l;
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto* item = g.add_items();
+        auto& itemLight = l.items.emplace_back();
+        item->set_id(i);
+        itemLight.id = i;
+        if (i % 3 != 0)
+        {
+            item->set_name(std::string(i % 50, 'a' + i % 26));
+            itemLight.name = item->name();
+        }
+    }
+
+    RepeatedScalarsLight strings;
+    for (int i = 0; i < 5000; ++i)
+        strings.r_strings.emplace_back(std::string(i % 40, 'z'));
+
+    ProtobufLight::ThreadPool pool(4);
+    ProtobufLight::Reflection::ParallelOptions options;
+    options.minParallelItems = 100;
+    options.grainSize = 64;
+
+    std::string out;
+    ProtobufLight::Reflection::SerializeStruct(l, out, pool, options);
+    REQUIRE(compareBuffers(g.SerializeAsString(), out));
+
+    std::string stringsOut;
+    ProtobufLight::Reflection::SerializeStruct(strings, stringsOut, pool, options);
+    REQUIRE(compareBuffers(strings.SerializeAsString(), stringsOut));
+
+    std::vector<uint8_t> vectorOut;
+    ProtobufLight::Reflection::SerializeStruct(l, vectorOut, pool, options);
+    REQUIRE(compareBuffers(out, std::string(vectorOut.begin(), vectorOut.end())));
+}
+
+TEST_CASE("Batch serialization") {
+    std::vector<ScalarsLight> messages(300);
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        messages[i].f_int32 = static_cast<int32_t>(i);
+        messages[i].f_string = std::string(i % 150, 'b');
+    }
+
+    auto batch = ProtobufLight::Reflection::SerializeBatch(messages);
+    REQUIRE(batch.size() == messages.size());
+    REQUIRE(batch.offsets.front() == 0);
+    REQUIRE(batch.offsets.back() == batch.buffer.size());
+
+    for (size_t i = 0; i < messages.size(); ++i)
+    {
+        REQUIRE(compareBuffers(messages[i].SerializeAsString(), std::string(batch.Message(i))));
+
+        ScalarsLight parsed;
+        auto payload = batch.Message(i);
+        REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(payload.data()), payload.size()));
+        REQUIRE(parsed.f_int32 == messages[i].f_int32);
+        REQUIRE(parsed.f_string == messages[i].f_string);
+    }
+
+    auto corrupted = batch;
+    corrupted.buffer[corrupted.offsets[1]] ^= 0x01;
+    REQUIRE_THROWS_AS(corrupted.Message(1), ProtobufLight::ParseError);
+
+    auto empty = ProtobufLight::Reflection::SerializeBatch(std::vector<ScalarsLight>{});
+    REQUIRE(empty.size() == 0);
+    REQUIRE(empty.buffer.empty());
+
+    // A region too small for the message throws, the bytes past it are left alone
+    std::array<uint8_t, 8> region{};
+    ProtobufLight::SpanBuffer span(region.data(), 4);
+    REQUIRE_THROWS_AS(ProtobufLight::Reflection::SerializeStruct(messages[149], span), std::length_error);
+    REQUIRE(span.size() <= 4);
+    REQUIRE(std::all_of(region.begin() + 4, region.end(), [](uint8_t b) { return b == 0; }));
+}
+
+TEST_CASE("Pmr arena parsing") {
+    // Long strings, so they don't fit in the small string buffer
+    const std::string longName(64, 'n');
+
+    RepeatedMessages g;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto* item = g.add_items();
+        item->set_id(i);
+        item->set_name(longName);
+    }
+    auto* wrapper = g.add_wrappers();
+    wrapper->mutable_single()->set_name(longName);
+    wrapper->add_many()->set_name(longName);
+
+    MapsMessages gm;
+    (*gm.mutable_m_str_msg())[longName].set_b(longName);
+    (*gm.mutable_m_i64_inner())[3].mutable_v()->set_b(longName);
+
+    const std::string bytes = g.SerializeAsString();
+    const std::string mapBytes = gm.SerializeAsString();
+
+    std::vector<std::byte> storage(1024 * 1024);
+    std::pmr::monotonic_buffer_resource arena(storage.data(), storage.size(), std::pmr::null_memory_resource());
+
+    // Any allocation outside of the arena would throw std::bad_alloc
+    auto* previous = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    ArenaRepeatedMessagesLight l(&arena);
+    ArenaMapsMessagesLight lm(&arena);
+    bool parsed = l.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()) &&
+        lm.ParseFromArray(reinterpret_cast<const uint8_t*>(mapBytes.data()), mapBytes.size());
+    std::pmr::set_default_resource(previous);
+
+    REQUIRE(parsed);
+    REQUIRE(l.items.size() == 100);
+    REQUIRE(l.items[99].name.get_allocator().resource() == &arena);
+    REQUIRE(l.wrappers[0].many[0].name.get_allocator().resource() == &arena);
+    REQUIRE(lm.m_str_msg.begin()->second.b.get_allocator().resource() == &arena);
+    REQUIRE(compareBuffers(bytes, l.SerializeAsString()));
+    REQUIRE(compareBuffers(mapBytes, lm.SerializeAsString()));
+}
+
+TEST_CASE("Optional hasbits") {
+    OptionalPresence g;
+    g.set_o_int32(0);
+    g.set_o_enum(OPT_ONE);
+    g.mutable_msg()->set_x(5);
+
+    OptionalHasbitsLight l;
+    l.set_o_int32(0);
+    l.set_o_enum(OptHasbitsEnumLight::OPT_HASBITS_ONE);
+    l.msg.x = 5;
+
+    roundtrip(g, l);
+
+    // Present zero is written, absent string is not
+    const std::string bytes = g.SerializeAsString();
+    OptionalHasbitsLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(parsed.has_o_int32());
+    REQUIRE(parsed.o_int32 == 0);
+    REQUIRE_FALSE(parsed.has_o_string());
+    REQUIRE(parsed.has_o_enum());
+
+    parsed.clear_o_int32();
+    REQUIRE_FALSE(parsed.has_o_int32());
+    REQUIRE(parsed.GetByteSize() + 2 == bytes.size());
+
+    REQUIRE(sizeof(OptionalHasbitsLight) < sizeof(OptionalPresenceLight));
+}
+
+TEST_CASE("Packed layout") {
+    Scalars g;
+    g.set_f_int32(42);
+    g.set_f_int64(-7);
+    g.set_f_bool(true);
+    g.set_f_double(1.5);
+    g.set_f_string("hello");
+    g.set_f_enum(TestEnum::ENUM_TWO);
+
+    LayoutScalarsLight l;
+    l.f_int32 = 42;
+    l.f_int64 = -7;
+    l.f_bool = true;
+    l.f_double = 1.5;
+    l.f_string = "hello";
+    l.f_enum = LayoutEnumLight::LAYOUT_ENUM_TWO;
+
+    // Members are reordered, the wire keeps field number order
+    roundtrip(g, l);
+    REQUIRE(sizeof(LayoutScalarsLight) < sizeof(ScalarsLight));
+}
+
+TEST_CASE("Cold fields") {
+    Scalars g;
+    g.set_f_int32(42);
+    g.set_f_string("hello");
+    g.set_f_enum(TestEnum::ENUM_TWO);
+
+    ColdScalarsLight l;
+    l.f_int32 = 42;
+    l.f_string = "hello";
+    l.f_enum = ColdEnumLight::COLD_ENUM_TWO;
+
+    roundtrip(g, l);
+
+    // Only hot fields on the wire, the cold struct is never allocated
+    const std::string hotBytes = g.SerializeAsString();
+    ColdScalarsLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(hotBytes.data()), hotBytes.size()));
+    REQUIRE_FALSE(parsed._cold.HasValue());
+    REQUIRE(parsed.f_double() == 0.0);
+    REQUIRE_FALSE(parsed._cold.HasValue());
+
+    g.set_f_uint64(7);
+    g.set_f_double(2.5);
+    g.set_f_bytes("cold");
+    l.set_f_uint64(7);
+    l.mutable_f_double() = 2.5;
+    l.set_f_bytes("cold");
+
+    roundtrip(g, l);
+
+    const std::string coldBytes = g.SerializeAsString();
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(coldBytes.data()), coldBytes.size()));
+    REQUIRE(parsed._cold.HasValue());
+    REQUIRE(parsed.f_bytes() == "cold");
+
+    ColdScalarsLight copy = parsed;
+    REQUIRE(copy.f_uint64() == 7);
+    REQUIRE(compareBuffers(coldBytes, copy.SerializeAsString()));
+}
+
+TEST_CASE("Narrow enums") {
+    static_assert(sizeof(NarrowEnumLight) == 1);
+    static_assert(std::is_same_v<std::underlying_type_t<NarrowSignedEnumLight>, int16_t>);
+    static_assert(std::is_same_v<std::underlying_type_t<NarrowOpenEnumLight>, int32_t>);
+
+    RepeatedScalars g;
+    g.add_r_int32_default_packed(1);
+    g.add_r_enums_default_packed(R_ONE);
+    g.add_r_enums_default_packed(R_TWO);
+    g.add_r_enums_default_packed(R_ZERO);
+
+    NarrowRepeatedScalarsLight l;
+    l.r_int32_default_packed.emplace_back(1);
+    l.r_enums_default_packed.emplace_back(NarrowEnumLight::NARROW_ONE);
+    l.r_enums_default_packed.emplace_back(NarrowEnumLight::NARROW_TWO);
+    l.r_enums_default_packed.emplace_back(NarrowEnumLight::NARROW_ZERO);
+
+    roundtrip(g, l);
+
+    // Values that don't fit in a byte are dropped
+    g.add_r_enums_default_packed(static_cast<ReEnum>(300));
+    g.add_r_enums_default_packed(R_ONE);
+    const std::string bytes = g.SerializeAsString();
+    NarrowRepeatedScalarsLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(parsed.r_enums_default_packed.size() == 4);
+    REQUIRE(parsed.r_enums_default_packed.back() == NarrowEnumLight::NARROW_ONE);
+}
+
+TEST_CASE("Packed bools") {
+    Defaults g;
+    g.set_i32(3);
+    g.set_b(true);
+    g.set_d(0.5);
+
+    PackedBoolsLight l;
+    l.i32 = 3;
+    l.set_b(true);
+    l.d = 0.5;
+
+    roundtrip(g, l);
+
+    // Long enough for the 8 values at a time decoder plus a tail
+    RepeatedScalars gr;
+    PackedRepeatedBoolsLight lr;
+    for (int i = 0; i < 203; ++i)
+    {
+        const bool value = (i % 3 == 0) || (i % 7 == 0);
+        gr.add_r_int32_default_packed(value ? 1 : 0);
+        lr.r_int32_default_packed.push_back(value);
+    }
+
+    roundtrip(gr, lr);
+
+    // Any non zero varint is true, multi byte ones included
+    gr.add_r_int32_default_packed(300);
+    const std::string bytes = gr.SerializeAsString();
+    PackedRepeatedBoolsLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(parsed.r_int32_default_packed.size() == 204);
+    REQUIRE(parsed.r_int32_default_packed[203]);
+    REQUIRE(parsed.r_int32_default_packed[21]);
+    REQUIRE_FALSE(parsed.r_int32_default_packed[202]);
+}
+
+TEST_CASE("Boxed oneof") {
+    OneOfAll g;
+    g.set_o_bytes(std::string(100, 'b'));
+
+    BoxedOneOfAllLight l;
+    l.choice = ProtobufLight::Box<std::string>(std::string(100, 'b'));
+
+    roundtrip(g, l);
+
+    g.mutable_o_msg()->set_id(12);
+    l.choice = BoxedOneMsgLight{ 12 };
+
+    roundtrip(g, l);
+
+    const std::string bytes = OneOfAll().SerializeAsString() + std::string("\x1a\x03" "abc");
+    BoxedOneOfAllLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(*std::get<ProtobufLight::Box<std::string>>(parsed.choice) == "abc");
+
+    BoxedOneOfAllLight copy = parsed;
+    REQUIRE(*std::get<ProtobufLight::Box<std::string>>(copy.choice) == "abc");
+
+    // A moved from message keeps a value in its box, it can still be copied and serialized
+    BoxedOneOfAllLight moved = std::move(copy);
+    REQUIRE(*std::get<ProtobufLight::Box<std::string>>(moved.choice) == "abc");
+    BoxedOneOfAllLight copyOfMovedFrom = copy;
+    REQUIRE(copyOfMovedFrom.SerializeAsString() == copy.SerializeAsString());
+    REQUIRE(std::get<ProtobufLight::Box<std::string>>(copy.choice)->empty());
+    copy = std::move(moved);
+    REQUIRE(*std::get<ProtobufLight::Box<std::string>>(copy.choice) == "abc");
+    REQUIRE(std::get<ProtobufLight::Box<std::string>>(moved.choice).get() != nullptr);
+    REQUIRE(moved.GetByteSize() == 2);
+
+    REQUIRE(sizeof(BoxedOneOfAllLight) < sizeof(OneOfAllLight));
+}
+
+TEST_CASE("Flat and hash maps") {
+    MapsMessages g;
+    (*g.mutable_m_str_msg())["k"].set_a(7);
+    FlatMapsMessagesLight l;
+    l.m_str_msg["k"].a = 7;
+
+    roundtrip(g, l);
+
+    MapsScalars gs;
+    (*gs.mutable_m_i32_str())[3] = "three";
+    HashMapsScalarsLight ls;
+    ls.m_i32_str[3] = "three";
+
+    roundtrip(gs, ls);
+
+    MapsMessages many;
+    for (int i = 50; i > 0; --i)
+        (*many.mutable_m_i32_msg())[i].set_a(i * 2);
+    // A repeated key on the wire replaces the earlier entry
+    const std::string bytes = many.SerializeAsString() + std::string("\x12\x06\x08\x05\x12\x02\x08\x63", 8);
+
+    FlatMapsMessagesLight flat;
+    REQUIRE(flat.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(flat.m_i32_msg.size() == 50);
+    REQUIRE(std::is_sorted(flat.m_i32_msg.begin(), flat.m_i32_msg.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; }));
+    REQUIRE(flat.m_i32_msg.at(5).a == 99);
+    REQUIRE(flat.m_i32_msg.at(17).a == 34);
+    REQUIRE_FALSE(flat.m_i32_msg.contains(51));
+
+    MapsMessagesLight ordered;
+    REQUIRE(ordered.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(ordered.m_i32_msg.at(5).a == 99);
+    REQUIRE(ordered.SerializeAsString() == flat.SerializeAsString());
+
+    // The list constructor sorts and keeps the last of repeated keys
+    const ProtobufLight::FlatMap<int, int> listed{ { 3, 30 }, { 1, 10 }, { 2, 20 }, { 1, 11 } };
+    REQUIRE(listed.size() == 3);
+    REQUIRE(std::is_sorted(listed.begin(), listed.end(), [](const auto& a, const auto& b) { return a.first < b.first; }));
+    REQUIRE(listed.find(1) != listed.end());
+    REQUIRE(listed.find(1)->second == 11);
+    REQUIRE(listed.at(3) == 30);
+}
+
+TEST_CASE("Shared bytes") {
+    Scalars g;
+    g.set_f_string("name");
+    g.set_f_bytes(std::string(1000, 'x'));
+    SharedScalarsLight l;
+    l.f_string = "name";
+    l.f_bytes = std::string(1000, 'x');
+
+    roundtrip(g, l);
+
+    RepeatedScalars gr;
+    gr.add_r_bytes("first");
+    gr.add_r_bytes(std::string(500, 'y'));
+    SharedRepeatedLight lr;
+    lr.r_bytes = { std::string("first"), std::string(500, 'y') };
+
+    roundtrip(gr, lr);
+
+    // Parsing from a shared buffer slices it, the fields keep it alive
+    SharedRepeatedLight parsed;
+    {
+        const ProtobufLight::SharedBytes buffer(gr.SerializeAsString());
+        REQUIRE(ProtobufLight::Reflection::ParseStruct(parsed, buffer));
+        REQUIRE(buffer.Contains(parsed.r_bytes[1].data(), parsed.r_bytes[1].size()));
+        REQUIRE(buffer.UseCount() == 3);
+    }
+    REQUIRE(parsed.r_bytes[0].View() == "first");
+    REQUIRE(parsed.r_bytes[1] == lr.r_bytes[1]);
+
+    // Forwarding a field shares it too
+    SharedScalarsLight forwarded;
+    forwarded.f_bytes = parsed.r_bytes[1];
+    REQUIRE(forwarded.f_bytes.data() == parsed.r_bytes[1].data());
+    REQUIRE(forwarded.f_bytes.UseCount() == 3);
+
+    // Without a shared buffer the bytes are copied
+    const std::string bytes = gr.SerializeAsString();
+    SharedRepeatedLight copied;
+    REQUIRE(copied.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(copied.r_bytes[1] == lr.r_bytes[1]);
+    REQUIRE(copied.r_bytes[1].UseCount() == 1);
+}
+
+TEST_CASE("Compact repeated strings") {
+    RepeatedScalars g;
+    g.add_r_int32_default_packed(1);
+    g.add_r_strings("alpha");
+    g.add_r_strings("");
+    g.add_r_strings(std::string(300, 's'));
+    g.add_r_bytes(std::string("\0\1\2", 3));
+
+    StringListScalarsLight l;
+    l.r_int32_default_packed.emplace_back(1);
+    l.r_strings = { "alpha", "", std::string_view(std::string(300, 's')) };
+    l.r_bytes.push_back(std::string_view("\0\1\2", 3));
+
+    roundtrip(g, l);
+
+    const std::string bytes = g.SerializeAsString();
+    StringListScalarsLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(parsed.r_strings.size() == 3);
+    REQUIRE(parsed.r_strings[0] == "alpha");
+    REQUIRE(parsed.r_strings[1].empty());
+    REQUIRE(parsed.r_strings.back().size() == 300);
+    REQUIRE(parsed.r_strings.ByteSize() == 305);
+    REQUIRE(parsed.r_bytes.at(0) == std::string_view("\0\1\2", 3));
+    REQUIRE(parsed.r_strings == l.r_strings);
+
+    parsed.r_strings.pop_back();
+    REQUIRE(parsed.r_strings.size() == 2);
+    REQUIRE(parsed.r_strings.ByteSize() == 5);
+}
+
+TEST_CASE("Interned strings") {
+    Scalars g;
+    g.set_f_string("eu-west-1");
+    InternScalarsLight l;
+    l.f_string = "eu-west-1";
+
+    roundtrip(g, l);
+
+    MapsScalars gm;
+    (*gm.mutable_m_str_i32())["requests"] = 3;
+    InternMapsLight lm;
+    lm.m_str_i32["requests"] = 3;
+
+    roundtrip(gm, lm);
+
+    RepeatedScalars gr;
+    gr.add_r_strings("host-a");
+    gr.add_r_strings("host-b");
+    gr.add_r_strings("host-a");
+    const std::string bytes = gr.SerializeAsString();
+
+    // Equal strings of every parsed message share one table entry
+    std::vector<InternRepeatedLight> parsed(2);
+    for (auto& p : parsed)
+        REQUIRE(p.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+
+    REQUIRE(parsed[0].r_strings[0] == parsed[0].r_strings[2]);
+    REQUIRE(parsed[0].r_strings[0] != parsed[0].r_strings[1]);
+    REQUIRE(parsed[0].r_strings[1].Id() == parsed[1].r_strings[1].Id());
+    REQUIRE(parsed[1].r_strings[1].View() == "host-b");
+    REQUIRE(sizeof(ProtobufLight::InternedString) == sizeof(void*));
+
+    const ProtobufLight::InternedString empty("");
+    REQUIRE(empty.empty());
+    REQUIRE(empty == ProtobufLight::InternedString());
+}
+
+TEST_CASE("Small vectors") {
+    RepeatedScalars g;
+    g.add_r_int32_default_packed(1);
+    g.add_r_int32_default_packed(-2);
+    g.add_r_enums_default_packed(R_TWO);
+    g.add_r_strings("a");
+
+    SmallScalarsLight l;
+    l.r_int32_default_packed = { 1, -2 };
+    l.r_enums_default_packed.push_back(SmallEnumLight::S_TWO);
+    l.r_strings.emplace_back("a");
+
+    roundtrip(g, l);
+
+    const std::string bytes = g.SerializeAsString();
+    SmallScalarsLight parsed;
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size()));
+    REQUIRE(parsed.r_int32_default_packed.IsInline());
+    REQUIRE(parsed.r_strings.IsInline());
+    const SmallScalarsLight copy = parsed;
+    REQUIRE(copy.r_strings == parsed.r_strings);
+
+    // Past the inline capacity the items move to the heap
+    for (int i = 0; i < 10; ++i)
+        g.add_r_int32_default_packed(i);
+    const std::string more = g.SerializeAsString();
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(more.data()), more.size()));
+    REQUIRE_FALSE(parsed.r_int32_default_packed.IsInline());
+    REQUIRE(parsed.r_int32_default_packed.size() == 12);
+    REQUIRE(parsed.r_int32_default_packed[11] == 9);
+
+    SmallScalarsLight moved = std::move(parsed);
+    REQUIRE(moved.r_int32_default_packed.size() == 12);
+    REQUIRE(parsed.r_int32_default_packed.empty());
+
+    RepeatedMessages gm;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto* item = gm.add_items();
+        item->set_id(i);
+        item->set_name(std::string(40, 'n'));
+    }
+    gm.add_wrappers()->add_many()->set_id(7);
+
+    SmallMessagesLight lm;
+    for (int i = 0; i < 3; ++i)
+        lm.items.push_back(SmallItemLight{ i, std::string(40, 'n') });
+    lm.wrappers.emplace_back().many.emplace_back().id = 7;
+
+    roundtrip(gm, lm);
+}
+
+TEST_CASE("Recursive messages") {
+    NestedAll g;
+    g.mutable_root()->mutable_mid()->mutable_leaf();
+    g.add_forest()->add_mids()->add_leaves();
+
+    TreeLight l;
+    l.child.Mutable().child.Mutable().child.Mutable();
+    l.children.emplace_back().children.emplace_back().children.emplace_back();
+
+    roundtrip(g, l);
+
+    // Deep chain, every node comes from the pool
+    TreeLight deep;
+    TreeLight* node = &deep;
+    for (int i = 0; i < 500; ++i)
+        node = &node->child.Mutable();
+
+    const std::string bytes = deep.SerializeAsString();
+    ProtobufLight::Reflection::ParseOptions unlimitedDepth;
+    unlimitedDepth.maxDepth = 0;
+    TreeLight parsed;
+    REQUIRE(ProtobufLight::Reflection::ParseStruct(parsed, reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), unlimitedDepth));
+    int depth = 0;
+    for (const TreeLight* n = &parsed; n->child.HasValue(); n = &n->child.Get())
+        ++depth;
+    REQUIRE(depth == 500);
+    REQUIRE(ProtobufLight::NodePool<TreeLight>::Instance().Capacity() < 2048);
+
+    // A thread_local tree outliving the thread node cache frees its nodes to the shared list
+    std::thread([] {
+        thread_local TreeLight lateTree;
+        lateTree.child.Mutable().child.Mutable();
+    }).join();
+
+    // Mutually recursive messages: (1 + x) with x = 2
+    ExprLight expr;
+    auto& binary = ProtobufLight::EnsureVariant<ProtobufLight::NodePtr<BinaryLight>>(expr.node).Mutable();
+    binary.lhs.Mutable().node = int64_t(1);
+    binary.rhs.Mutable().node = ProtobufLight::NodePtr<BinaryLight>();
+    binary.bindings["x"].Mutable().node = int64_t(2);
+
+    const std::string exprBytes = expr.SerializeAsString();
+    ExprLight parsedExpr;
+    REQUIRE(parsedExpr.ParseFromArray(reinterpret_cast<const uint8_t*>(exprBytes.data()), exprBytes.size()));
+    const auto& parsedBinary = std::get<ProtobufLight::NodePtr<BinaryLight>>(parsedExpr.node).Get();
+    REQUIRE(std::get<int64_t>(parsedBinary.lhs.Get().node) == 1);
+    REQUIRE(std::holds_alternative<ProtobufLight::NodePtr<BinaryLight>>(parsedBinary.rhs.Get().node));
+    REQUIRE(std::get<int64_t>(parsedBinary.bindings.at("x").Get().node) == 2);
+    REQUIRE(parsedExpr.SerializeAsString() == exprBytes);
+
+    ExprLight copy = parsedExpr;
+    REQUIRE(copy.SerializeAsString() == exprBytes);
+}
+
+TEST_CASE("Columnar decoding") {
+    RepeatedMessages g;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto* item = g.add_items();
+        item->set_id(i * 10);
+        item->set_name("item" + std::to_string(i));
+    }
+    g.add_wrappers()->mutable_single()->set_id(99);
+
+    ColRepeatedMessagesLight l;
+    for (int i = 0; i < 3; ++i)
+    {
+        auto& item = l.items.emplace_back();
+        item.id = i * 10;
+        item.name = "item" + std::to_string(i);
+    }
+    l.wrappers.emplace_back().single.id = 99;
+
+    roundtrip(g, l);
+
+    // Items decode straight into columns, the wrappers field is skipped
+    const std::string bytes = g.SerializeAsString();
+    ColItemLightColumns cols;
+    REQUIRE(ProtobufLight::Reflection::ParseColumns(cols, reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), 1));
+    REQUIRE(cols.rows == 3);
+    REQUIRE(cols.id == std::vector<int32_t>{ 0, 10, 20 });
+    REQUIRE(!cols.id_present[0]);
+    REQUIRE(cols.id_present[1]);
+    REQUIRE(cols.id_present[2]);
+    REQUIRE(cols.name.size() == 3);
+    REQUIRE(cols.name[1] == "item1");
+    REQUIRE(cols.name_present[0]);
+
+    // A second message appends to the same columns
+    REQUIRE(ProtobufLight::Reflection::ParseColumns(cols, reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), 1));
+    REQUIRE(cols.rows == 6);
+    REQUIRE(cols.id[4] == 10);
+    REQUIRE(cols.name[5] == "item2");
+
+    // A row failing mid-decode is rolled back, its id column doesn't keep the half decoded value
+    const std::string broken("\x0a\x05\x08\x01\x12\x01\x61\x0a\x04\x08\x07\x10\x05", 13);
+    ColItemLightColumns partial;
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseColumns(partial, reinterpret_cast<const uint8_t*>(broken.data()), broken.size(), 1));
+    REQUIRE(partial.rows == 1);
+    REQUIRE(partial.id == std::vector<int32_t>{ 1 });
+    REQUIRE(partial.id_present.size() == 1);
+    REQUIRE(partial.id_present[0]);
+    REQUIRE(partial.name.size() == 1);
+    REQUIRE(partial.name_present.size() == 1);
+    REQUIRE(partial.name[0] == "a");
+}
+
+TEST_CASE("Frozen messages") {
+    RepeatedMessages g;
+    RepeatedMessagesLight l;
+    for (int i = 0; i < 100; ++i)
+    {
+        auto* item = g.add_items();
+        auto& itemLight = l.items.emplace_back();
+        item->set_id(i);
+        item->set_name("route" + std::to_string(i));
+        itemLight.id = i;
+        itemLight.name = item->name();
+    }
+
+    const ProtobufLight::Frozen<RepeatedMessagesLight> frozen = ProtobufLight::MakeFrozen(std::move(l));
+    REQUIRE(frozen->items.size() == 100);
+
+    // Every thread shares the same message and the same encoding
+    std::vector<std::string> outs(8);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < outs.size(); ++t)
+    {
+        workers.emplace_back([copy = frozen, &out = outs[t]]()
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                out.clear();
+                copy.SerializeTo(out);
+            }
+        });
+    }
+    for (auto& worker : workers)
+        worker.join();
+
+    const std::string expected = g.SerializeAsString();
+    for (const auto& out : outs)
+        REQUIRE(compareBuffers(expected, out));
+
+    REQUIRE(frozen.ByteSize() == expected.size());
+    REQUIRE(frozen.SerializeAsString() == expected);
+    REQUIRE(frozen.UseCount() == 1);
+
+    std::vector<uint8_t> vectorOut;
+    frozen.SerializeTo(vectorOut);
+    REQUIRE(compareBuffers(expected, std::string(vectorOut.begin(), vectorOut.end())));
+
+    // The bytes outlive the frozen message
+    ProtobufLight::SharedBytes bytes;
+    {
+        ProtobufLight::Frozen<RepeatedMessagesLight> copy = frozen;
+        bytes = copy.Bytes();
+        REQUIRE(bytes.data() == frozen.Bytes().data());
+    }
+    REQUIRE(bytes.View() == expected);
+
+    // A moved from handle still shares the message
+    ProtobufLight::Frozen<RepeatedMessagesLight> source = frozen;
+    ProtobufLight::Frozen<RepeatedMessagesLight> target = std::move(source);
+    REQUIRE(&source.Get() == &target.Get());
+    REQUIRE(source.ByteSize() == expected.size());
+    REQUIRE(source.SerializeAsString() == expected);
+
+    // Const messages serialize without mutable access, hasbits included
+    OptionalPresence optionalG;
+    optionalG.set_o_int32(7);
+    OptionalHasbitsLight optional;
+    optional.set_o_int32(7);
+    const OptionalHasbitsLight& constOptional = optional;
+    std::string constOut;
+    ProtobufLight::Reflection::SerializeStruct(constOptional, constOut);
+    REQUIRE(compareBuffers(optionalG.SerializeAsString(), constOut));
+    REQUIRE(ProtobufLight::MakeFrozen(optional).SerializeAsString() == constOut);
+}
+
+TEST_CASE("Message pool") {
+    RepeatedMessages g;
+    for (int i = 0; i < 50; ++i)
+    {
+        auto* item = g.add_items();
+        item->set_id(i);
+        item->set_name(std::string(40, 'a' + i % 26));
+    }
+    const std::string bytes = g.SerializeAsString();
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+
+    auto& pool = ProtobufLight::MessagePool<RepeatedMessagesLight>::ThreadLocal();
+    pool.ResetStats();
+
+    const RepeatedMessagesLight* first = nullptr;
+    size_t warmCapacity = 0;
+    {
+        auto message = ProtobufLight::Reflection::ParsePooled<RepeatedMessagesLight>(data, bytes.size());
+        REQUIRE(message);
+        REQUIRE(message->items.size() == 50);
+        first = &message.Get();
+        warmCapacity = message->items.capacity();
+    }
+    REQUIRE(pool.PooledMessages() == 1);
+
+    // The next request gets the same cleared message, containers still reserved
+    {
+        auto message = pool.Acquire();
+        REQUIRE(&message.Get() == first);
+        REQUIRE(message->items.empty());
+        REQUIRE(message->items.capacity() == warmCapacity);
+        REQUIRE(message->ParseFromArray(data, bytes.size()));
+        REQUIRE(message->items.capacity() == warmCapacity);
+        REQUIRE(compareBuffers(bytes, message->SerializeAsString()));
+    }
+    REQUIRE(pool.Stats().hits == 1);
+    REQUIRE(pool.Stats().misses == 1);
+    REQUIRE(pool.Stats().HitRate() == 0.5);
+
+    // A message holding more than the bound is freed instead of pooled
+    ProtobufLight::MessagePool<RepeatedMessagesLight> smallPool(4, 1024);
+    auto big = smallPool.Acquire();
+    big->items.resize(1000);
+    REQUIRE(ProtobufLight::Reflection::RetainedCapacity(big.Get()) > 1024);
+    smallPool.Release(big.Detach());
+    REQUIRE(smallPool.PooledMessages() == 0);
+    REQUIRE(smallPool.Stats().dropped == 1);
+
+    // Interned fields hold no heap of their own, their messages pool like any other
+    {
+        auto interned = ProtobufLight::MessagePool<InternScalarsLight>::ThreadLocal().Acquire();
+        interned->f_string = "eu-west-1";
+        REQUIRE(ProtobufLight::Reflection::RetainedCapacity(interned.Get()) == 0);
+    }
+    REQUIRE(ProtobufLight::MessagePool<InternScalarsLight>::ThreadLocal().PooledMessages() == 1);
+    REQUIRE(ProtobufLight::MessagePool<InternScalarsLight>::ThreadLocal().Acquire()->f_string.empty());
+
+    // A handle outliving its thread pool at thread exit frees its message instead of touching the dead pool
+    bool lateParsed = false;
+    std::thread([data, size = bytes.size(), &lateParsed]()
+    {
+        thread_local ProtobufLight::PooledMessage<RepeatedMessagesLight> lateMessage;
+        lateMessage = ProtobufLight::Reflection::ParsePooled<RepeatedMessagesLight>(data, size);
+        lateParsed = static_cast<bool>(lateMessage);
+    }).join();
+    REQUIRE(lateParsed);
+
+    // Clearing in place keeps presence semantics
+    OptionalHasbitsLight optional;
+    optional.set_o_int32(3);
+    optional.set_o_string(std::string(100, 'x'));
+    ProtobufLight::Reflection::ClearStruct(optional);
+    REQUIRE_FALSE(optional.has_o_int32());
+    REQUIRE_FALSE(optional.has_o_string());
+    REQUIRE(optional.o_string.capacity() >= 100);
+    REQUIRE(optional.GetByteSize() == 0);
+}
+
+TEST_CASE("Space used") {
+    RepeatedMessagesLight l;
+    l.items.reserve(16);
+    for (int i = 0; i < 10; ++i)
+    {
+        auto& item = l.items.emplace_back();
+        item.id = i;
+        item.name = std::string(100, 'n');
+    }
+
+    const auto report = ProtobufLight::Reflection::SpaceUsed(l);
+    REQUIRE(report.shallow == sizeof(RepeatedMessagesLight));
+    REQUIRE(report.byField.at("items").used == 10 * sizeof(l.items[0]));
+    REQUIRE(report.byField.at("items").slack == 6 * sizeof(l.items[0]));
+    REQUIRE(report.byField.at("items.name").used == 1000);
+    REQUIRE(report.byKind.at("string").used == 1000);
+    REQUIRE(report.byField.count("items.id") == 0);
+    REQUIRE(report.byField.count("wrappers") == 0);
+    REQUIRE(report.heap.Total() == ProtobufLight::Reflection::RetainedCapacity(l));
+    REQUIRE(report.Total() == report.shallow + report.heap.Total());
+
+    // Short strings stay inside the object
+    l.items[0].name = "x";
+    l.items[0].name.shrink_to_fit();
+    REQUIRE(ProtobufLight::Reflection::SpaceUsed(l).byField.at("items.name").used == 900);
+
+    MapsMessagesLight maps;
+    maps.m_str_msg[std::string(64, 'k')].a = 1;
+    maps.m_i32_msg[1].a = 2;
+    const auto mapReport = ProtobufLight::Reflection::SpaceUsed(maps);
+    REQUIRE(mapReport.byField.at("m_str_msg.key").used == 64);
+    REQUIRE(mapReport.byField.at("m_str_msg").used > 0);
+    REQUIRE(mapReport.byField.at("m_i32_msg").used > 0);
+    REQUIRE(mapReport.byKind.at("map").used == mapReport.byField.at("m_str_msg").used + mapReport.byField.at("m_i32_msg").used);
+
+    // Interned strings belong to the intern table
+    InternScalarsLight interned;
+    interned.f_string = std::string(100, 'i');
+    const auto internReport = ProtobufLight::Reflection::SpaceUsed(interned);
+    REQUIRE(internReport.shallow == sizeof(InternScalarsLight));
+    REQUIRE(internReport.heap.Total() == 0);
+    REQUIRE(internReport.byField.count("f_string") == 0);
+}
+
+TEST_CASE("Parse limits") {
+    // 50 bytes declaring 25 empty items
+    std::string bytes;
+    for (int i = 0; i < 25; ++i)
+        bytes += std::string("\x0A\x00", 2);
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+
+    RepeatedMessagesLight unbounded;
+    REQUIRE(unbounded.ParseFromArray(data, bytes.size()));
+    REQUIRE(unbounded.items.size() == 25);
+
+    ProtobufLight::Reflection::ParseOptions options;
+    options.maxAllocationBytes = 10 * sizeof(unbounded.items[0]);
+
+    ProtobufLight::Reflection::ParseContext ctx{};
+    ctx.options = options;
+    RepeatedMessagesLight bounded;
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseStruct(bounded, data, bytes.size(), ctx));
+    REQUIRE(ctx.limitExceeded);
+    REQUIRE(bounded.items.size() == 10);
+
+    // Strings count against the budget before they are copied
+    RepeatedMessages g;
+    g.add_items()->set_name(std::string(1000, 'x'));
+    const std::string stringBytes = g.SerializeAsString();
+    RepeatedMessagesLight strings;
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseStruct(strings, reinterpret_cast<const uint8_t*>(stringBytes.data()), stringBytes.size(), options));
+    options.maxAllocationBytes = 2000;
+    REQUIRE(ProtobufLight::Reflection::ParseStruct(strings, reinterpret_cast<const uint8_t*>(stringBytes.data()), stringBytes.size(), options));
+    REQUIRE(strings.items[0].name.size() == 1000);
+
+    // Nesting depth
+    TreeLight deep;
+    TreeLight* node = &deep;
+    for (int i = 0; i < 200; ++i)
+        node = &node->child.Mutable();
+    const std::string deepBytes = deep.SerializeAsString();
+
+    ProtobufLight::Reflection::ParseOptions depthOptions;
+    depthOptions.maxDepth = 100;
+    TreeLight parsed;
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseStruct(parsed, reinterpret_cast<const uint8_t*>(deepBytes.data()), deepBytes.size(), depthOptions));
+    depthOptions.maxDepth = 201;
+    REQUIRE(ProtobufLight::Reflection::ParseStruct(parsed, reinterpret_cast<const uint8_t*>(deepBytes.data()), deepBytes.size(), depthOptions));
+    REQUIRE(parsed.SerializeAsString() == deepBytes);
+
+    // Plain parsing stops at protobuf's default recursion limit of 100
+    REQUIRE_FALSE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(deepBytes.data()), deepBytes.size()));
+    TreeLight shallow;
+    node = &shallow;
+    for (int i = 0; i < 99; ++i)
+        node = &node->child.Mutable();
+    const std::string shallowBytes = shallow.SerializeAsString();
+    REQUIRE(parsed.ParseFromArray(reinterpret_cast<const uint8_t*>(shallowBytes.data()), shallowBytes.size()));
+
+    // Every allocating path is charged: oneof strings, boxes and nodes, copied shared bytes, interned strings
+    ProtobufLight::Reflection::ParseOptions tight;
+    tight.maxAllocationBytes = 100;
+    const auto exceedsBudget = [&tight](auto& message, const std::string& encoded)
+    {
+        ProtobufLight::Reflection::ParseContext limited{};
+        limited.options = tight;
+        const bool ok = ProtobufLight::Reflection::ParseStruct(message, reinterpret_cast<const uint8_t*>(encoded.data()), encoded.size(), limited);
+        return !ok && limited.limitExceeded;
+    };
+    const std::string large(100000, 'x');
+
+    OneOfAllLight oneofString;
+    oneofString.choice = large;
+    REQUIRE(exceedsBudget(oneofString, oneofString.SerializeAsString()));
+
+    BoxedOneOfAllLight boxedString;
+    boxedString.choice = ProtobufLight::Box<std::string>(large);
+    REQUIRE(exceedsBudget(boxedString, boxedString.SerializeAsString()));
+
+    ExprLight expr;
+    ProtobufLight::EnsureVariant<ProtobufLight::NodePtr<BinaryLight>>(expr.node).Mutable();
+    const std::string exprBytes = expr.SerializeAsString();
+    tight.maxAllocationBytes = sizeof(BinaryLight) - 1;
+    REQUIRE(exceedsBudget(expr, exprBytes));
+    tight.maxAllocationBytes = sizeof(BinaryLight);
+    REQUIRE_FALSE(exceedsBudget(expr, exprBytes));
+    tight.maxAllocationBytes = 100;
+
+    SharedScalarsLight sharedBytes;
+    sharedBytes.f_bytes = large;
+    REQUIRE(exceedsBudget(sharedBytes, sharedBytes.SerializeAsString()));
+
+    InternScalarsLight internedString;
+    internedString.f_string = large;
+    REQUIRE(exceedsBudget(internedString, internedString.SerializeAsString()));
+}
+
+TEST_CASE("Parallel parsing") {
+    RepeatedMessages g;
+    for (int i = 0; i < 5000; ++i)
+    {
+        auto* item = g.add_items();
+        item->set_id(i);
+        if (i % 3 != 0)
+            item->set_name(std::string(i % 50, 'a' + i % 26));
+    }
+    for (int i = 0; i < 300; ++i)
+    {
+        auto* wrapper = g.add_wrappers();
+        wrapper->mutable_single()->set_id(i + 1);
+        wrapper->add_many()->set_name("w" + std::to_string(i));
+    }
+    const std::string bytes = g.SerializeAsString();
+    const auto* data = reinterpret_cast<const uint8_t*>(bytes.data());
+
+    ProtobufLight::ThreadPool pool(4);
+    ProtobufLight::Reflection::ParallelOptions options;
+    options.minParallelItems = 100;
+    options.grainSize = 64;
+
+    RepeatedMessagesLight serial;
+    REQUIRE(serial.ParseFromArray(data, bytes.size()));
+
+    RepeatedMessagesLight parallel;
+    REQUIRE(ProtobufLight::Reflection::ParseStruct(parallel, data, bytes.size(), pool, options));
+    REQUIRE(parallel.items.size() == 5000);
+    REQUIRE(parallel.wrappers.size() == 300);
+    REQUIRE(parallel.items[4999].id == 4999);
+    REQUIRE(compareBuffers(serial.SerializeAsString(), parallel.SerializeAsString()));
+    REQUIRE(compareBuffers(bytes, parallel.SerializeAsString()));
+
+    // A broken element fails the whole parse
+    std::string broken = bytes;
+    broken += std::string("\x0A\x02\x08", 3);
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseStruct(parallel, reinterpret_cast<const uint8_t*>(broken.data()), broken.size(), pool, options));
+
+    // Parse limits apply to the parallel tasks too, they share one allocation budget
+    ProtobufLight::Reflection::ParseOptions limits;
+    limits.maxAllocationBytes = 1000;
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseStruct(parallel, data, bytes.size(), pool, options, limits));
+    // Room for the element table and the items, but not for their names
+    limits.maxAllocationBytes = 5300 * sizeof(std::string_view) + 5000 * sizeof(parallel.items[0]);
+    REQUIRE_FALSE(ProtobufLight::Reflection::ParseStruct(parallel, data, bytes.size(), pool, options, limits));
+    limits.maxAllocationBytes = 10 * 1024 * 1024;
+    REQUIRE(ProtobufLight::Reflection::ParseStruct(parallel, data, bytes.size(), pool, options, limits));
+    REQUIRE(compareBuffers(bytes, parallel.SerializeAsString()));
+
+    // Items of a pmr vector share its unsynchronized memory resource, they are parsed on the calling thread
+    static_assert(!ProtobufLight::Reflection::Detail::is_parallel_message_field_v<decltype(ArenaRepeatedMessagesLight::items)>);
+    std::pmr::monotonic_buffer_resource arena;
+    ArenaRepeatedMessagesLight arenaParsed(&arena);
+    REQUIRE(ProtobufLight::Reflection::ParseStruct(arenaParsed, data, bytes.size(), pool, options));
+    REQUIRE(arenaParsed.items.size() == 5000);
+    REQUIRE(arenaParsed.items[4999].name.get_allocator().resource() == &arena);
+    REQUIRE(compareBuffers(bytes, arenaParsed.SerializeAsString()));
+}
+
+TEST_CASE("Batch parsing") {
+    std::vector<std::string> inputs;
+    for (int i = 0; i < 500; ++i)
+    {
+        RepeatedMessages g;
+        // Mostly small messages, a few big ones
+        const int items = i % 97 == 0 ? 2000 : i % 5;
+        for (int j = 0; j < items; ++j)
+        {
+            auto* item = g.add_items();
+            item->set_id(i + j + 1);
+            item->set_name(std::string(j % 20, 'a' + i % 26));
+        }
+        inputs.push_back(g.SerializeAsString());
+    }
+    inputs[123] = std::string("\x0A\x05\x08", 3);
+
+    std::vector<RepeatedMessagesLight> outputs(inputs.size());
+    ProtobufLight::WorkStealingThreadPool pool(4);
+    ProtobufLight::Reflection::BatchParseOptions options;
+    options.chunkBytes = 1024;
+    options.maxChunkItems = 16;
+
+    const auto result = ProtobufLight::Reflection::ParseBatch(inputs, outputs, pool, options);
+    REQUIRE(result.failures == 1);
+    REQUIRE_FALSE(result.AllSucceeded());
+    REQUIRE(result.succeeded[123] == 0);
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        if (i != 123)
+        {
+            REQUIRE(result.succeeded[i] != 0);
+            REQUIRE(compareBuffers(inputs[i], outputs[i].SerializeAsString()));
+        }
+    }
+
+    // Batches parsed from inside pool tasks run on the submitting worker queue and get stolen by the others
+    std::vector<std::vector<RepeatedMessagesLight>> nestedOutputs(4, std::vector<RepeatedMessagesLight>(inputs.size()));
+    std::vector<ProtobufLight::Reflection::BatchParseResult> nestedResults(4);
+    ProtobufLight::ParallelFor(pool, 4, 1, [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; ++b)
+            nestedResults[b] = ProtobufLight::Reflection::ParseBatch(inputs, nestedOutputs[b], pool, options);
+    });
+    for (size_t b = 0; b < 4; ++b)
+    {
+        REQUIRE(nestedResults[b].failures == 1);
+        REQUIRE(compareBuffers(inputs[194], nestedOutputs[b][194].SerializeAsString()));
+    }
+
+    std::vector<RepeatedMessagesLight> tooFew(inputs.size() - 1);
+    REQUIRE_THROWS_AS(ProtobufLight::Reflection::ParseBatch(inputs, tooFew, pool, options), std::invalid_argument);
+}